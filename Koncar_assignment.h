@@ -2,6 +2,17 @@
 // Licence information: Copyright Filip Matjašec©
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
+// koncar: containers, bulk appends, hexadecimal conversion and file-system utilities in one header.
+//
+// Background threads: the header starts no thread when it is included. Two function-local statics start
+// threads on first use and join them at exit:
+//   - koncar::default_executor(): one worker per available CPU, the first time a parallel policy or a task
+//     group runs without an explicit executor;
+//   - koncar::default_diagnostics(): one writer thread, the first time a koncar function reports an error.
+//     Reports queued at exit are written before the thread is joined.
+
+#pragma once
+
 #include <filesystem>
 #include <iostream>
 #include <ostream>
@@ -9,178 +20,5601 @@
 #include <initializer_list>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#define KONCAR_POSIX_FILES 1
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Vectorized kernels are compiled per function with target attributes and chosen at run time
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define KONCAR_X86_KERNELS 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
 
 namespace koncar {
 
     // namespace alias for std::filesystem
     namespace fs = std::filesystem;
-    
-    // Task 1 - Version 1
+
+    class executor;
+
+    // Execution policies
+    //****************************************************************
+    /**
+     * @brief Execution policies accepted by koncar bulk operations.
+     *
+     * These mirror std::execution::seq/par but are plain tag types: including <execution> drags in a
+     * parallel backend (TBB with libstdc++) which every user of this header would then have to link.
+     */
+    namespace execution {
+
+        // Run on the calling thread
+        struct sequenced_policy {};
+
+        /**
+         * @brief Run on several threads once the amount of work is large enough to pay for them.
+         *
+         * @param threshold Number of elements below which the operation stays on the calling thread.
+         * @param grain Minimum number of elements handed to one thread.
+         * @param max_threads Upper bound on the number of threads, 0 means every worker of the executor plus the caller.
+         * @param executor The koncar::executor which runs the work, nullptr means koncar::default_executor().
+         */
+        struct parallel_policy {
+            std::size_t threshold = std::size_t{ 1 } << 16;
+            std::size_t grain = std::size_t{ 1 } << 15;
+            unsigned max_threads = 0;
+            koncar::executor* executor = nullptr;
+        };
+
+        inline constexpr sequenced_policy seq{};
+        inline constexpr parallel_policy par{};
+
+        // Satisfied by the koncar execution policy types
+        template <typename Policy>
+        concept policy = std::same_as<std::remove_cvref_t<Policy>, sequenced_policy>
+            || std::same_as<std::remove_cvref_t<Policy>, parallel_policy>;
+
+    }
+
+    // Execution - Executor
     //****************************************************************
+    namespace detail {
+
+        // Type-erased, move-only callable taking no arguments
+        class task {
+        public:
+            task() noexcept = default;
+
+            template <typename Function>
+            explicit task(Function&& function) : impl_(std::make_unique<model<std::decay_t<Function>>>(std::forward<Function>(function))) {}
+
+            explicit operator bool() const noexcept {
+                return impl_ != nullptr;
+            }
+
+            void operator()() {
+                impl_->run();
+            }
+
+        private:
+            struct callable {
+                virtual ~callable() = default;
+                virtual void run() = 0;
+            };
+
+            template <typename Function>
+            struct model final : callable {
+                template <typename F>
+                explicit model(F&& f) : function(std::forward<F>(f)) {}
+
+                void run() override {
+                    function();
+                }
+
+                Function function;
+            };
+
+            std::unique_ptr<callable> impl_;
+        };
+
+        // Calls `visit(cpu)` for every CPU of a Linux cpulist such as "0-3,8,10-11"
+        template <typename Visitor>
+        void for_each_cpu_in_list(const std::string_view list, Visitor visit) {
+            const char* it = list.data();
+            const char* const end = list.data() + list.size();
+            while (it < end) {
+                unsigned first = 0;
+                std::from_chars_result parsed = std::from_chars(it, end, first);
+                if (parsed.ec != std::errc())
+                    return;
+                unsigned last = first;
+                if (parsed.ptr < end && *parsed.ptr == '-') {
+                    parsed = std::from_chars(parsed.ptr + 1, end, last);
+                    if (parsed.ec != std::errc())
+                        return;
+                }
+                const char* const next = parsed.ptr;
+                for (unsigned cpu = first; cpu <= last; ++cpu)
+                    visit(cpu);
+                it = next < end && *next == ',' ? next + 1 : end;
+            }
+        }
+
+        /**
+         * @brief The logical CPUs this process may run on and the NUMA node of each, detected once.
+         *
+         * On Linux the CPUs come from the affinity mask and the nodes from /sys/devices/system/node;
+         * elsewhere, or when that information is unavailable, all CPUs are reported on node 0.
+         */
+        struct cpu_topology {
+            std::vector<unsigned> cpus;
+            std::vector<unsigned> nodes;
+            unsigned node_count = 1;
+
+            static const cpu_topology& get() {
+                static const cpu_topology topology = detect();
+                return topology;
+            }
+
+            // NUMA node of a logical CPU, 0 if it is unknown
+            unsigned node_of(const unsigned cpu) const noexcept {
+                const auto it = std::ranges::find(cpus, cpu);
+                return it == cpus.end() ? 0 : nodes[static_cast<std::size_t>(it - cpus.begin())];
+            }
+
+        private:
+            static cpu_topology detect() {
+                cpu_topology topology;
+                std::vector<unsigned> node_by_cpu;
+#if defined(__linux__)
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                if (sched_getaffinity(0, sizeof set, &set) == 0) {
+                    for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                        if (CPU_ISSET(cpu, &set))
+                            topology.cpus.push_back(cpu);
+                    }
+                }
+                std::error_code error;
+                for (fs::directory_iterator it("/sys/devices/system/node", error), end; !error && it != end; it.increment(error)) {
+                    const std::string name = it->path().filename().string();
+                    unsigned node = 0;
+                    if (!name.starts_with("node") || std::from_chars(name.data() + 4, name.data() + name.size(), node).ec != std::errc())
+                        continue;
+                    std::ifstream file(it->path() / "cpulist");
+                    std::string list;
+                    std::getline(file, list);
+                    for_each_cpu_in_list(list, [&](const unsigned cpu) {
+                        if (cpu >= node_by_cpu.size())
+                            node_by_cpu.resize(cpu + 1, 0);
+                        node_by_cpu[cpu] = node;
+                    });
+                }
+#endif
+                if (topology.cpus.empty()) {
+                    for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu)
+                        topology.cpus.push_back(cpu);
+                }
+
+                // Renumber the nodes which actually contain allowed CPUs as 0, 1, ...
+                std::vector<unsigned> present;
+                for (const unsigned cpu : topology.cpus) {
+                    const unsigned node = cpu < node_by_cpu.size() ? node_by_cpu[cpu] : 0;
+                    auto it = std::ranges::find(present, node);
+                    if (it == present.end())
+                        it = present.insert(present.end(), node);
+                    topology.nodes.push_back(static_cast<unsigned>(it - present.begin()));
+                }
+                topology.node_count = static_cast<unsigned>(present.size());
+                return topology;
+            }
+        };
+
+        // Binds the calling thread to one logical CPU; returns false where that is not supported
+        inline bool pin_current_thread(const unsigned cpu) noexcept {
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            return pthread_setaffinity_np(pthread_self(), sizeof set, &set) == 0;
+#else
+            (void)cpu;
+            return false;
+#endif
+        }
+
+        // The logical CPU the calling thread is running on, or -1 if that is unknown
+        inline int current_cpu() noexcept {
+#if defined(__linux__)
+            return sched_getcpu();
+#else
+            return -1;
+#endif
+        }
+
+    }
+
+    /**
+     * @brief Options for constructing a koncar::executor.
+     *
+     * @param threads Number of worker threads, 0 means one per CPU the process may run on.
+     * @param pin_threads Bind worker i to the i-th CPU the process may run on (Linux only).
+     * @param numa_aware Steal from workers on the same NUMA node first, and queue tasks submitted by threads outside
+     * the pool on a worker of the submitting thread's node (Linux only; without NUMA there is a single node).
+     */
+    struct executor_options {
+        unsigned threads = 0;
+        bool pin_threads = false;
+        bool numa_aware = true;
+    };
+
     /**
-     * @brief Adds elements to a container using variadic arguments.
+     * @brief A work-stealing thread pool shared by all parallel koncar operations.
+     *
+     * Every worker owns a task deque. A worker pops its own newest task first (depth-first, cache friendly) and,
+     * when it runs dry, steals the oldest task of another worker, trying workers on its own NUMA node before
+     * the others. Tasks submitted from a worker go to that worker's deque; tasks submitted from other threads are
+     * spread over the workers. Idle workers sleep on a condition variable and cost nothing.
      *
-     * This function adds elements to the specified container using variadic arguments.
-     * It accepts any number of arguments and appends them to the end of the container.
-     * The type of container must support the `emplace_back` operation.
-     * We utilize a fold expression (left-hand side) introduced in C++17 to efficiently add elements to the container.
+     * @details Operations accept an executor through their options (execution::parallel_policy::executor) and
+     * otherwise use koncar::default_executor(), a process-wide pool created on first use, so nested and concurrent
+     * koncar operations share one set of threads instead of oversubscribing the cores. Threads waiting for their
+     * work (task_group::wait, parallel_for) run queued tasks themselves, so waiting inside a task cannot deadlock.
      *
-     * @tparam Container The type of container to which elements will be added.
-     * @tparam Args The types of elements to be added to the container.
-     * @param container The container to which elements will be added.
-     * @param args The elements to be added to the container.
+     * An exception escaping a task passed to `submit` terminates the program, as it would on a std::thread;
+     * koncar::task_group and koncar::parallel_for forward exceptions to the waiting thread instead.
+     * The destructor runs all queued tasks, then joins the workers.
      *
-     * @details This function utilizes a variadic function template to accept any number of arguments
-     * and adds them to the end of the container using the `emplace_back` operation.
-     * It is suitable for situations where a variable number of elements need to be appended to a container which supports the 'emplace_back' function.
-     * By using a container rvalue reference (Container&&), this function can handle:
-     * 1. In-place construction
-     * 2. Modifying existing containers
-     * 
      * Example usage:
      * \code{.cpp}
-     * std::vector<int> vector;
-     * koncar::add_range(vector, 1, 2, 3, 4, 5);
-     * // vector now contains {1, 2, 3, 4, 5}
+     * koncar::executor pool({ .threads = 8, .pin_threads = true });
+     * koncar::parallel_for(0, frames.size(), [&](std::size_t i) { process(frames[i]); },
+     *                      { .threshold = 1, .grain = 16, .executor = &pool });
      * \endcode
      */
-    template <typename Container, typename... Args>
-    void add_range(Container&& container, Args&&... args) {
-        (container.emplace_back(std::forward<Args>(args)), ...);
+    class executor {
+    public:
+        explicit executor(const executor_options& options = {}) : numa_aware_(options.numa_aware) {
+            const detail::cpu_topology& topology = detail::cpu_topology::get();
+            const std::size_t count = options.threads ? options.threads : topology.cpus.size();
+
+            workers_.reserve(count);
+            for (std::size_t index = 0; index < count; ++index) {
+                auto worker = std::make_unique<worker_state>();
+                const std::size_t slot = index % topology.cpus.size();
+                worker->cpu = topology.cpus[slot];
+                worker->node = options.numa_aware ? topology.nodes[slot] : 0;
+                workers_.push_back(std::move(worker));
+            }
+            node_workers_.resize(options.numa_aware ? topology.node_count : 1);
+            for (std::size_t index = 0; index < count; ++index)
+                node_workers_[workers_[index]->node].push_back(index);
+
+            // Victims in stealing order: the following workers of the same node, then the following workers of other nodes
+            for (std::size_t index = 0; index < count; ++index) {
+                auto& victims = workers_[index]->victims;
+                for (const bool same_node : { true, false }) {
+                    for (std::size_t offset = 1; offset < count; ++offset) {
+                        const std::size_t victim = (index + offset) % count;
+                        if ((workers_[victim]->node == workers_[index]->node) == same_node)
+                            victims.push_back(victim);
+                    }
+                }
+            }
+
+            threads_.reserve(count);
+            try {
+                for (std::size_t index = 0; index < count; ++index)
+                    threads_.emplace_back([this, index, pin = options.pin_threads] { work(index, pin); });
+            } catch (...) {
+                stop();
+                throw;
+            }
+        }
+
+        executor(const executor&) = delete;
+        executor& operator=(const executor&) = delete;
+
+        ~executor() {
+            stop();
+        }
+
+        /**
+         * @brief Returns the number of worker threads.
+         */
+        std::size_t concurrency() const noexcept {
+            return workers_.size();
+        }
+
+        /**
+         * @brief Returns whether the calling thread is one of this executor's workers.
+         */
+        bool owns_current_thread() const noexcept {
+            return current_ == this;
+        }
+
+        /**
+         * @brief Queues `function` to run on a worker thread.
+         */
+        template <typename Function>
+        void submit(Function&& function) {
+            push(pick_worker(), detail::task([function = std::forward<Function>(function)]() mutable noexcept { function(); }));
+        }
+
+        /**
+         * @brief Runs one queued task on the calling thread, if there is one.
+         * @return Whether a task was run.
+         */
+        bool try_run_one() {
+            detail::task task = take(owns_current_thread() ? current_index_ : no_worker);
+            if (!task)
+                return false;
+            task();
+            return true;
+        }
+
+        /**
+         * @brief Runs queued tasks on the calling thread until `done()` returns true, sleeping while there is nothing to run.
+         *
+         * `done` is re-evaluated whenever a task group of this executor completes (see koncar::task_group).
+         */
+        template <typename Predicate>
+        void run_until(Predicate done) {
+            while (!done()) {
+                const std::uint32_t epoch = activity_.load(std::memory_order_acquire);
+                if (done())
+                    return;
+                if (!try_run_one())
+                    activity_.wait(epoch, std::memory_order_acquire);
+            }
+        }
+
+    private:
+        friend class task_group;
+
+        static constexpr std::size_t no_worker = std::numeric_limits<std::size_t>::max();
+
+        struct alignas(64) worker_state {
+            std::mutex mutex;
+            std::deque<detail::task> tasks;
+            std::vector<std::size_t> victims;
+            unsigned cpu = 0;
+            unsigned node = 0;
+        };
+
+        static inline thread_local const executor* current_ = nullptr;
+        static inline thread_local std::size_t current_index_ = 0;
+
+        void work(const std::size_t index, const bool pin) {
+            current_ = this;
+            current_index_ = index;
+            if (pin)
+                detail::pin_current_thread(workers_[index]->cpu);
+            for (;;) {
+                if (detail::task task = take(index)) {
+                    task();
+                    continue;
+                }
+                std::unique_lock lock(sleep_mutex_);
+                sleepers_.fetch_add(1);
+                wake_.wait(lock, [this] { return stopping_ || queued_.load() > 0; });
+                sleepers_.fetch_sub(1);
+                if (stopping_ && queued_.load() == 0)
+                    return;
+            }
+        }
+
+        // Worker whose deque receives a task submitted by the calling thread
+        std::size_t pick_worker() noexcept {
+            if (owns_current_thread())
+                return current_index_;
+            const std::size_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+            if (numa_aware_ && node_workers_.size() > 1) {
+                if (const int cpu = detail::current_cpu(); cpu >= 0) {
+                    const auto& local = node_workers_[detail::cpu_topology::get().node_of(static_cast<unsigned>(cpu))];
+                    if (!local.empty())
+                        return local[ticket % local.size()];
+                }
+            }
+            return ticket % workers_.size();
+        }
+
+        void push(const std::size_t index, detail::task task) {
+            {
+                std::lock_guard lock(workers_[index]->mutex);
+                workers_[index]->tasks.push_back(std::move(task));
+            }
+            queued_.fetch_add(1);
+            // Pairs with the sleepers_ increment in work(): either the sleeper sees the task or this sees the sleeper
+            if (sleepers_.load() > 0) {
+                { std::lock_guard lock(sleep_mutex_); }
+                wake_.notify_one();
+            }
+            notify_activity();
+        }
+
+        // Pops the newest task of worker `index`, otherwise steals the oldest task of another worker
+        detail::task take(const std::size_t index) {
+            detail::task task;
+            if (index != no_worker) {
+                worker_state& own = *workers_[index];
+                std::lock_guard lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                }
+            }
+            if (!task) {
+                const auto steal = [&](const std::size_t victim) {
+                    worker_state& other = *workers_[victim];
+                    std::lock_guard lock(other.mutex);
+                    if (other.tasks.empty())
+                        return false;
+                    task = std::move(other.tasks.front());
+                    other.tasks.pop_front();
+                    return true;
+                };
+                if (index != no_worker) {
+                    for (const std::size_t victim : workers_[index]->victims) {
+                        if (steal(victim))
+                            break;
+                    }
+                } else {
+                    const std::size_t start = next_.load(std::memory_order_relaxed);
+                    for (std::size_t offset = 0; offset < workers_.size() && !steal((start + offset) % workers_.size()); ++offset) {}
+                }
+            }
+            if (task)
+                queued_.fetch_sub(1);
+            return task;
+        }
+
+        void notify_activity() noexcept {
+            activity_.fetch_add(1, std::memory_order_release);
+            activity_.notify_all();
+        }
+
+        void stop() noexcept {
+            {
+                std::lock_guard lock(sleep_mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto& thread : threads_) {
+                if (thread.joinable())
+                    thread.join();
+            }
+        }
+
+        std::vector<std::unique_ptr<worker_state>> workers_;
+        std::vector<std::vector<std::size_t>> node_workers_;
+        std::vector<std::thread> threads_;
+        bool numa_aware_;
+
+        alignas(64) std::atomic<std::size_t> queued_{ 0 };
+        std::atomic<std::size_t> sleepers_{ 0 };
+        std::atomic<std::size_t> next_{ 0 };
+        std::atomic<std::uint32_t> activity_{ 0 };
+        std::mutex sleep_mutex_;
+        std::condition_variable wake_;
+        bool stopping_ = false;
+    };
+
+    /**
+     * @brief Returns the process-wide executor used by koncar operations which are not given one.
+     *
+     * It is created on first use with one worker per CPU the process may run on, and destroyed at exit.
+     */
+    inline executor& default_executor() {
+        static executor instance;
+        return instance;
     }
 
-    // Task 1 - Version 2
-    //****************************************************************
     /**
-     * @brief Adds elements to a container using an initializer list.
+     * @brief Runs a dynamic set of tasks on an executor and waits for all of them.
+     *
+     * Tasks may add further tasks to the same group. `wait` runs queued tasks on the calling thread until the group
+     * is empty and then rethrows the first exception thrown by any task. The destructor waits as well, but
+     * discards exceptions.
      *
-     * This function adds elements to the specified container using an initializer list.
-     * It inserts elements from the initializer list at the end of the container.
+     * Example usage:
+     * \code{.cpp}
+     * koncar::task_group group;
+     * for (auto& shard : shards)
+     *     group.run([&shard] { shard.compact(); });
+     * group.wait();
+     * \endcode
+     */
+    class task_group {
+    public:
+        explicit task_group(executor& pool = default_executor()) : pool_(pool) {}
+
+        task_group(const task_group&) = delete;
+        task_group& operator=(const task_group&) = delete;
+
+        ~task_group() {
+            pool_.run_until([this] { return pending_.load(std::memory_order_acquire) == 0; });
+        }
+
+        template <typename Function>
+        void run(Function&& function) {
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            pool_.submit([this, function = std::forward<Function>(function)]() mutable {
+                try {
+                    function();
+                } catch (...) {
+                    std::lock_guard lock(error_mutex_);
+                    if (!error_)
+                        error_ = std::current_exception();
+                }
+                // The group may be destroyed as soon as pending_ reaches zero, so the executor is read first
+                executor& pool = pool_;
+                if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    pool.notify_activity();
+            });
+        }
+
+        void wait() {
+            pool_.run_until([this] { return pending_.load(std::memory_order_acquire) == 0; });
+            std::lock_guard lock(error_mutex_);
+            if (error_)
+                std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+
+    private:
+        executor& pool_;
+        std::atomic<std::size_t> pending_{ 0 };
+        std::mutex error_mutex_;
+        std::exception_ptr error_;
+    };
+
+    namespace detail {
+
+        /**
+         * @brief Splits [0, count) into contiguous slices and runs `function(first, last)` on every slice in parallel.
+         *
+         * Slices run on the policy's executor (koncar::default_executor() by default), and the calling thread
+         * processes the first slice itself. The first exception thrown by any slice is rethrown once all slices
+         * have finished.
+         */
+        template <typename Function>
+        void parallel_slices(const std::size_t count, const execution::parallel_policy& policy, Function&& function) {
+            executor& pool = policy.executor ? *policy.executor : default_executor();
+            const std::size_t max_tasks = policy.max_threads ? policy.max_threads : pool.concurrency() + (pool.owns_current_thread() ? 0 : 1);
+            const std::size_t tasks = std::clamp<std::size_t>(count / std::max<std::size_t>(policy.grain, 1), 1, std::max<std::size_t>(max_tasks, 1));
+            const std::size_t slice = count / tasks;
+            const std::size_t remainder = count % tasks;
+
+            const auto run = [&](const std::size_t index) {
+                const std::size_t first = index * slice + std::min(index, remainder);
+                function(first, first + slice + (index < remainder ? 1 : 0));
+            };
+            if (tasks == 1) {
+                run(0);
+                return;
+            }
+
+            task_group group(pool);
+            for (std::size_t index = 1; index < tasks; ++index)
+                group.run([&run, index] { run(index); });
+            std::exception_ptr error;
+            try {
+                run(0);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            try {
+                group.wait();
+            } catch (...) {
+                if (!error)
+                    error = std::current_exception();
+            }
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+    }
+
+    /**
+     * @brief Calls `function(i)` for every index in [first, last), in parallel on a koncar::executor.
      *
-     * @tparam Container The type of container to which elements will be added.
-     * @tparam T The type of elements in the initializer list.
-     * @param container The container to which elements will be added.
-     * @param values The initializer list containing elements to be added to the container.
+     * @param first The first index.
+     * @param last One past the last index.
+     * @param function Callable invoked with each index as std::size_t.
+     * @param policy Fewer than `policy.threshold` indices run on the calling thread; otherwise the indices are split
+     * into contiguous slices of at least `policy.grain` indices on `policy.executor` (default: koncar::default_executor()).
      *
-     * @details This function takes an initializer list of elements and inserts them at the end of the container.
-     * It is suitable for situations where a set of elements needs to be appended to a container using an initializer list.
-     * By using a container rvalue reference (Container&&), this function can handle:
-     * 1. In-place construction
-     * 2. Modifying existing containers
+     * @details The defaults suit cheap per-index work such as copying elements; for coarse work items lower the
+     * threshold and grain. The calling thread takes part in the work, and the first exception thrown by `function`
+     * is rethrown after all slices have finished.
      *
      * Example usage:
      * \code{.cpp}
-     * std::vector<int> vector;
-     * koncar::add_range(vector, {1, 2, 3, 4, 5});
-     * // vector now contains {1, 2, 3, 4, 5}
+     * koncar::parallel_for(0, images.size(), [&](std::size_t i) { thumbnails[i] = scale(images[i]); },
+     *                      { .threshold = 2, .grain = 1 });
      * \endcode
      */
-    template <typename Container, typename T>
-    void add_range(Container&& container, std::initializer_list<T> values) {
-        container.insert(container.end(), values.begin(), values.end());
+    template <typename Function>
+    void parallel_for(const std::size_t first, const std::size_t last, Function&& function, const execution::parallel_policy& policy = {}) {
+        if (last <= first)
+            return;
+        const std::size_t count = last - first;
+        if (count < policy.threshold) {
+            for (std::size_t index = first; index < last; ++index)
+                function(index);
+            return;
+        }
+        detail::parallel_slices(count, policy, [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t index = begin; index < end; ++index)
+                function(first + index);
+        });
     }
     
-    // Task 2.1
+    // Implementation details shared by the add_range overloads
+    //****************************************************************
+    namespace detail {
+
+        /**
+         * @brief Satisfied by containers which can pre-allocate storage for future elements.
+         *
+         * Standard examples are std::vector and std::basic_string. Containers such as std::deque or std::list
+         * do not model this concept because they have no notion of capacity.
+         */
+        template <typename Container>
+        concept reservable = requires(Container& container, std::size_t count) {
+            container.reserve(count);
+            { container.size() } -> std::convertible_to<std::size_t>;
+            { container.capacity() } -> std::convertible_to<std::size_t>;
+        };
+
+        // Satisfied by containers which never relocate their elements when they grow (koncar::segmented_vector)
+        template <typename Container>
+        concept stable_references = requires { requires Container::stable_references; };
+
+        /**
+         * @brief Satisfied by containers with a fixed maximum number of elements, such as ring buffers.
+         *
+         * Such containers report `size`/`capacity` but cannot grow, so add_range checks up front that
+         * the whole batch fits instead of failing half way through it.
+         */
+        template <typename Container>
+        concept fixed_capacity = !reservable<Container> && requires(const Container& container) {
+            { container.size() } -> std::convertible_to<std::size_t>;
+            { container.capacity() } -> std::convertible_to<std::size_t>;
+        };
+
+        // Satisfied by std::unordered_set, std::unordered_map and containers with the same interface
+        template <typename Container>
+        concept unordered_associative = requires(Container& container, std::size_t count) {
+            typename Container::hasher;
+            typename Container::key_equal;
+            container.reserve(count);
+        };
+
+        // Satisfied by std::set, std::map and containers with the same interface
+        template <typename Container>
+        concept ordered_associative = requires(Container& container, typename Container::const_iterator hint) {
+            typename Container::key_compare;
+            { container.emplace_hint(hint, *container.begin()) } -> std::same_as<typename Container::iterator>;
+        };
+
+        /**
+         * @brief Makes room for `count` additional elements using at most one allocation.
+         *
+         * Does nothing for containers which are not reservable or which already have enough spare capacity.
+         * When the container has to grow, the new capacity is at least twice the old one, so calling add_range
+         * repeatedly with a few elements keeps the amortized constant cost of geometric growth instead of
+         * relocating all elements on every call. Containers which grow without relocating
+         * (see stable_references) reserve exactly what is required.
+         *
+         * @param container The container which is about to receive `count` elements.
+         * @param count The number of elements which will be appended.
+         */
+        template <typename Container>
+        void reserve_additional(Container& container, const std::size_t count) {
+            if constexpr (reservable<Container>) {
+                const std::size_t required = container.size() + count;
+                if (required <= container.capacity())
+                    return;
+                if constexpr (stable_references<Container>)
+                    container.reserve(required);
+                else
+                    container.reserve(std::max<std::size_t>(required, container.capacity() * 2));
+            }
+        }
+
+        /**
+         * @brief Prepares `container` for `count` new elements.
+         *
+         * Unordered containers rehash once for their final size, reservable sequences reserve storage
+         * (see reserve_additional) and fixed-capacity containers throw std::length_error when the batch does not fit.
+         *
+         * @param container The container which is about to receive `count` elements.
+         * @param count The number of elements which will be appended.
+         */
+        template <typename Container>
+        void prepare(Container& container, const std::size_t count) {
+            if constexpr (unordered_associative<Container>) {
+                container.reserve(container.size() + count);
+            } else if constexpr (reservable<Container>) {
+                reserve_additional(container, count);
+            } else if constexpr (fixed_capacity<Container>) {
+                if (count > container.capacity() - container.size())
+                    throw std::length_error("add_range: not enough capacity for " + std::to_string(count) + " elements");
+            }
+        }
+
+        // Insertion hint kept by appender: an iterator for ordered associative containers, nothing otherwise
+        struct no_hint {};
+
+        template <typename Container>
+        struct hint_type {
+            using type = no_hint;
+        };
+
+        template <ordered_associative Container>
+        struct hint_type<Container> {
+            using type = typename Container::iterator;
+        };
+
+        /**
+         * @brief Adds elements one at a time using the best single-element operation of the container.
+         *
+         * 1. Ordered associative containers use hinted insertion. The hint is the position after the previously
+         *    inserted element, so sorted input costs amortized O(1) per element instead of O(log n).
+         * 2. Sequences use `emplace_back`, or `push_back` when there is no `emplace_back` (std::basic_string).
+         * 3. Unordered associative containers use `emplace`.
+         * 4. Other sequences use `insert(end(), ...)`.
+         * 5. Containers which can only grow at the front (std::forward_list) use `emplace_front`,
+         *    so the elements end up in reverse order, as with std::front_inserter.
+         */
+        template <typename Container>
+        class appender {
+        public:
+            explicit appender(Container& container) : container_(container) {
+                if constexpr (ordered_associative<Container>)
+                    hint_ = container_.end();
+            }
+
+            template <typename Arg>
+            void operator()(Arg&& arg) {
+                if constexpr (ordered_associative<Container>)
+                    hint_ = std::next(container_.emplace_hint(hint_, std::forward<Arg>(arg)));
+                else if constexpr (requires { container_.emplace_back(std::forward<Arg>(arg)); })
+                    container_.emplace_back(std::forward<Arg>(arg));
+                else if constexpr (requires { container_.push_back(std::forward<Arg>(arg)); })
+                    container_.push_back(std::forward<Arg>(arg));
+                else if constexpr (requires { container_.emplace(std::forward<Arg>(arg)); })
+                    container_.emplace(std::forward<Arg>(arg));
+                else if constexpr (requires { container_.insert(container_.end(), std::forward<Arg>(arg)); })
+                    container_.insert(container_.end(), std::forward<Arg>(arg));
+                else
+                    container_.emplace_front(std::forward<Arg>(arg));
+            }
+
+        private:
+            Container& container_;
+            [[no_unique_address]] typename hint_type<Container>::type hint_{};
+        };
+
+        // Element type of a (possibly reference qualified) container
+        template <typename Container>
+        using element_t = typename std::remove_cvref_t<Container>::value_type;
+
+        // Satisfied when `Arg` can be added to `Container` as one element: it either constructs an element,
+        // or the container accepts it directly (koncar::soa_vector takes whole records through push_back)
+        template <typename Container, typename Arg>
+        concept addable = std::constructible_from<element_t<Container>, Arg>
+            || requires(std::remove_reference_t<Container>& container, Arg&& arg) { container.push_back(std::forward<Arg>(arg)); };
+
+        // Satisfied by a range passed as an rvalue which owns its elements (e.g. a temporary std::vector),
+        // so its elements may be moved from instead of copied
+        template <typename Range>
+        concept owning_rvalue = !std::is_lvalue_reference_v<Range> && !std::ranges::borrowed_range<Range>;
+
+        /**
+         * @brief Satisfied when the elements of `Range` should be appended one by one to `Container`.
+         *
+         * A range which can itself be added as an element (e.g. a std::string appended to a
+         * std::vector<std::string>) is treated as a single element and handled by the variadic overload instead.
+         * The elements of an owning rvalue range only need to be addable once moved from.
+         */
+        template <typename Container, typename Range>
+        concept appendable_range = std::ranges::input_range<Range>
+            && !addable<Container, Range>
+            && (addable<Container, std::ranges::range_reference_t<Range>>
+                || (owning_rvalue<Range> && addable<Container, std::ranges::range_rvalue_reference_t<Range>>));
+
+        /**
+         * @brief Satisfied when `I`/`S` form an iterator pair rather than two elements of `Container`.
+         */
+        template <typename Container, typename I, typename S>
+        concept appendable_iterators = std::input_iterator<I> && std::sentinel_for<S, I>
+            && !addable<Container, I>
+            && addable<Container, std::iter_reference_t<I>>;
+
+        // Satisfied when the bytes of `Range` can be copied straight into a contiguous container of `T`
+        template <typename Range, typename T>
+        concept memcpy_compatible = std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range>
+            && std::is_trivially_copyable_v<T>
+            && std::same_as<std::remove_cv_t<std::ranges::range_value_t<Range>>, T>;
+
+        /**
+         * @brief Appends `count` trivially copyable elements stored contiguously at `first`.
+         *
+         * Pointer based `insert` lets the standard library copy the whole block with a single memmove.
+         * Containers without a range `insert` but with `resize` and `data` are grown once and filled with memcpy.
+         * Unordered containers receive the block through `insert(first, last)`.
+         */
+        template <typename Container, typename T>
+        void append_contiguous(Container& container, const T* first, const std::size_t count) {
+            if constexpr (requires { container.insert(container.end(), first, first + count); }) {
+                container.insert(container.end(), first, first + count);
+            } else if constexpr (requires { container.resize(count); { container.data() } -> std::convertible_to<T*>; }) {
+                const std::size_t old_size = container.size();
+                container.resize(old_size + count);
+                if (count)
+                    std::memcpy(container.data() + old_size, first, count * sizeof(T));
+            } else if constexpr (unordered_associative<Container>) {
+                container.insert(first, first + count);
+            } else {
+                appender<Container> append(container);
+                for (std::size_t i = 0; i < count; ++i)
+                    append(first[i]);
+            }
+        }
+
+        // Adds the elements of `range` one by one, moving them out of the range when `Move` is true
+        template <bool Move, typename Container, typename Range>
+        void append_each(Container& container, Range& range) {
+            appender<Container> append(container);
+            for (auto it = std::ranges::begin(range); it != std::ranges::end(range); ++it) {
+                if constexpr (Move)
+                    append(std::ranges::iter_move(it));
+                else
+                    append(*it);
+            }
+        }
+
+        /**
+         * @brief Adds every element of `range` using the cheapest operation available.
+         *
+         * 1. Containers with a C++23 `append_range` member are handed the whole range.
+         * 2. Sized (or multi-pass) ranges prepare the container once (see prepare); contiguous ranges of trivially
+         *    copyable elements are then copied as one block, everything else is added element by element.
+         * 3. Single-pass ranges of trivially copyable elements are staged in fixed-size chunks on the stack
+         *    and every chunk is added as one block.
+         * Elements of a range passed as an owning rvalue (e.g. a temporary std::vector) are moved, not copied.
+         */
+        template <typename Container, typename Range>
+        void append_range(Container& container, Range&& range) {
+            using value_type = typename Container::value_type;
+
+            if constexpr (requires { container.append_range(std::forward<Range>(range)); }) {
+                container.append_range(std::forward<Range>(range));
+            } else if constexpr (memcpy_compatible<Range, value_type>) {
+                const auto count = static_cast<std::size_t>(std::ranges::size(range));
+                prepare(container, count);
+                append_contiguous(container, std::ranges::data(range), count);
+            } else if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>) {
+                prepare(container, static_cast<std::size_t>(std::ranges::distance(range)));
+                append_each<owning_rvalue<Range>>(container, range);
+            } else if constexpr (std::is_trivially_copyable_v<value_type> && std::is_trivially_default_constructible_v<value_type>) {
+                constexpr std::size_t chunk_size = std::max<std::size_t>(1, 4096 / sizeof(value_type));
+                value_type chunk[chunk_size];
+                std::size_t count = 0;
+                for (auto&& element : range) {
+                    chunk[count++] = static_cast<value_type>(std::forward<decltype(element)>(element));
+                    if (count == chunk_size) {
+                        prepare(container, count);
+                        append_contiguous(container, chunk, count);
+                        count = 0;
+                    }
+                }
+                prepare(container, count);
+                append_contiguous(container, chunk, count);
+            } else {
+                append_each<owning_rvalue<Range>>(container, range);
+            }
+        }
+
+        // Satisfied when `range` can be copied into `Container` by resizing it once and assigning disjoint slices.
+        // Elements must be real objects: slices of a proxy-reference container such as std::vector<bool> share
+        // words, so threads assigning neighbouring slices would race.
+        template <typename Container, typename Range>
+        concept parallel_appendable = std::ranges::random_access_range<Range> && std::ranges::sized_range<Range>
+            && std::ranges::random_access_range<Container> && std::default_initializable<element_t<Container>>
+            && std::is_lvalue_reference_v<std::ranges::range_reference_t<Container>>
+            && requires(Container& container, std::size_t count) { container.resize(count); { container.size() } -> std::convertible_to<std::size_t>; };
+
+        // Poison pill: stops unqualified lookup inside add_range_fn at this point, so that only
+        // customizations found by argument-dependent lookup are considered and never koncar::add_range itself
+        void add_range() = delete;
+
+        /**
+         * @brief Satisfied when the container type provides its own add_range, found by argument-dependent lookup.
+         */
+        template <typename Container, typename... Args>
+        concept custom_add_range = requires(Container& container, Args&&... args) {
+            add_range(container, std::forward<Args>(args)...);
+        };
+
+        // Compile-time capacity of containers which can never grow (koncar::static_vector), unbounded otherwise
+        template <typename Container>
+        inline constexpr std::size_t static_capacity_v = std::numeric_limits<std::size_t>::max();
+
+        template <typename Container>
+            requires requires { { std::remove_cvref_t<Container>::static_capacity } -> std::convertible_to<std::size_t>; }
+        inline constexpr std::size_t static_capacity_v<Container> = std::remove_cvref_t<Container>::static_capacity;
+
+        /**
+         * @brief Function object type of koncar::add_range.
+         *
+         * Every overload first checks whether the container provides its own `add_range` (see custom_add_range)
+         * and otherwise selects the best built-in strategy for the container at compile time.
+         */
+        struct add_range_fn {
+
+            // Task 1 - Version 1
+            //****************************************************************
+            /**
+             * @brief Adds elements to a container using variadic arguments.
+             *
+             * This function adds elements to the specified container using variadic arguments.
+             * It accepts any number of arguments and adds them to the container.
+             * Sequences receive the elements at their end through `emplace_back` (or `push_back`),
+             * associative containers through (hinted) `emplace`, see detail::appender.
+             * We utilize a fold expression (left-hand side) introduced in C++17 to efficiently add elements to the container.
+             * The container is prepared for all of the arguments up front (see detail::prepare), so the whole call
+             * costs at most one allocation for reservable sequences and at most one rehash for unordered containers.
+             * Containers with a compile-time capacity (koncar::static_vector) reject a pack which can never fit with a static_assert.
+             *
+             * @tparam Container The type of container to which elements will be added.
+             * @tparam Args The types of elements to be added to the container.
+             * @param container The container to which elements will be added.
+             * @param args The elements to be added to the container.
+             *
+             * @details This function utilizes a variadic function template to accept any number of arguments
+             * and adds them to the container using the best single-element operation it supports.
+             * It is suitable for situations where a variable number of elements need to be added to a container.
+             * By using a container rvalue reference (Container&&), this function can handle:
+             * 1. In-place construction
+             * 2. Modifying existing containers
+             * 
+             * Example usage:
+             * \code{.cpp}
+             * std::vector<int> vector;
+             * koncar::add_range(vector, 1, 2, 3, 4, 5);
+             * // vector now contains {1, 2, 3, 4, 5}
+             * \endcode
+             */
+            template <typename Container, typename... Args>
+                requires (!execution::policy<Container>)
+            void operator()(Container&& container, Args&&... args) const {
+                static_assert(sizeof...(Args) <= static_capacity_v<Container>, "add_range: more elements than the container can ever hold");
+                if constexpr (custom_add_range<Container, Args...>) {
+                    add_range(container, std::forward<Args>(args)...);
+                } else {
+                    prepare(container, sizeof...(Args));
+                    appender<std::remove_reference_t<Container>> append(container);
+                    (append(std::forward<Args>(args)), ...);
+                }
+            }
+
+            // Task 1 - Version 2
+            //****************************************************************
+            /**
+             * @brief Adds elements to a container using an initializer list.
+             *
+             * This function adds elements to the specified container using an initializer list.
+             * It inserts elements from the initializer list at the end of the container (or into an associative container).
+             * The container is prepared for all of the values up front, and the values are copied as a single block when possible.
+             * Since the elements of an initializer list are const and can only be copied, this overload is limited to
+             * trivially copyable types; braced lists of other types (e.g. std::string) are moved in by Version 5.
+             *
+             * @tparam Container The type of container to which elements will be added.
+             * @tparam T The type of elements in the initializer list.
+             * @param container The container to which elements will be added.
+             * @param values The initializer list containing elements to be added to the container.
+             *
+             * @details This function takes an initializer list of elements and inserts them at the end of the container.
+             * It is suitable for situations where a set of elements needs to be appended to a container using an initializer list.
+             * By using a container rvalue reference (Container&&), this function can handle:
+             * 1. In-place construction
+             * 2. Modifying existing containers
+             *
+             * Example usage:
+             * \code{.cpp}
+             * std::vector<int> vector;
+             * koncar::add_range(vector, {1, 2, 3, 4, 5});
+             * // vector now contains {1, 2, 3, 4, 5}
+             * \endcode
+             */
+            template <typename Container, typename T>
+                requires std::is_trivially_copyable_v<T>
+            void operator()(Container&& container, std::initializer_list<T> values) const {
+                append_all(container, std::ranges::subrange(values.begin(), values.end()));
+            }
+
+            // Task 1 - Version 3
+            //****************************************************************
+            /**
+             * @brief Adds all elements of a range to a container.
+             *
+             * This function appends every element of a C++20 range (another container, a std::span, a view, ...)
+             * to the specified container.
+             *
+             * @tparam Container The type of container to which elements will be added.
+             * @tparam Range The type of the input range.
+             * @param container The container to which elements will be added.
+             * @param range The range whose elements will be added to the container.
+             *
+             * @details If the range is an rvalue which owns its elements (e.g. a temporary std::vector or std::array),
+             * the elements are moved into the container instead of being copied.
+             * The cheapest available operation is selected at compile time (see detail::append_range):
+             * containers with `append_range` receive the whole range, sized ranges prepare the container once,
+             * contiguous ranges of trivially copyable elements are copied as a single block (memmove/memcpy),
+             * and single-pass ranges of trivially copyable elements are appended in stack-buffered chunks.
+             * A range which can itself be converted to the element type (e.g. a std::string appended to a
+             * std::vector<std::string>) is added as a single element by Version 1 instead.
+             *
+             * Example usage:
+             * \code{.cpp}
+             * std::vector<int> vector;
+             * const std::array<int, 3> source = { 1, 2, 3 };
+             * koncar::add_range(vector, source);
+             * koncar::add_range(vector, std::views::iota(4, 6));
+             * // vector now contains {1, 2, 3, 4, 5}
+             * \endcode
+             */
+            template <typename Container, typename Range>
+                requires appendable_range<Container, Range>
+            void operator()(Container&& container, Range&& range) const {
+                append_all(container, std::forward<Range>(range));
+            }
+
+            // Task 1 - Version 4
+            //****************************************************************
+            /**
+             * @brief Adds the elements of an iterator range [first, last) to a container.
+             *
+             * This function appends every element in [first, last) to the specified container.
+             * It behaves exactly like Version 3 applied to `std::ranges::subrange(first, last)`, so pointer pairs over
+             * trivially copyable elements are copied as a single block.
+             *
+             * @tparam Container The type of container to which elements will be added.
+             * @tparam I The iterator type.
+             * @tparam S The sentinel type.
+             * @param container The container to which elements will be added.
+             * @param first Iterator to the first element to be added.
+             * @param last Sentinel marking the end of the elements to be added.
+             *
+             * Example usage:
+             * \code{.cpp}
+             * std::vector<uint8_t> vector;
+             * const uint8_t bytes[] = { 0xBA, 0xAD, 0xF0, 0x0D };
+             * koncar::add_range(vector, std::begin(bytes), std::end(bytes));
+             * // vector now contains { 0xBA, 0xAD, 0xF0, 0x0D }
+             * \endcode
+             */
+            template <typename Container, typename I, typename S>
+                requires appendable_iterators<Container, I, S>
+            void operator()(Container&& container, I first, S last) const {
+                append_all(container, std::ranges::subrange(std::move(first), std::move(last)));
+            }
+
+            // Task 1 - Version 5
+            //****************************************************************
+            /**
+             * @brief Adds elements to a container by moving them out of a braced list (or any array rvalue).
+             *
+             * This function is selected for braced lists of types which are not trivially copyable, such as
+             * `koncar::add_range(vector, { std::string(...), std::string(...) })`. Unlike std::initializer_list,
+             * the temporary array bound to `values` is not const, so every element is moved into the container.
+             *
+             * @tparam Container The type of container to which elements will be added.
+             * @tparam T The type of elements in the array.
+             * @tparam N The number of elements in the array.
+             * @param container The container to which elements will be added.
+             * @param values The array rvalue whose elements will be moved into the container.
+             *
+             * @details The container is prepared for all N elements up front, so appending N heavy objects
+             * to a reservable sequence costs N move constructions and at most one allocation.
+             *
+             * Example usage:
+             * \code{.cpp}
+             * std::vector<std::string> vector;
+             * koncar::add_range(vector, { std::string(1000, 'a'), std::string(1000, 'b') });
+             * // vector now contains both strings, and neither of them was copied
+             * \endcode
+             */
+            template <typename Container, typename T, std::size_t N>
+            void operator()(Container&& container, T (&&values)[N]) const {
+                static_assert(N <= static_capacity_v<Container>, "add_range: more elements than the container can ever hold");
+                append_all(container, std::ranges::subrange(std::make_move_iterator(std::begin(values)),
+                                                            std::make_move_iterator(std::end(values))));
+            }
+
+            // Task 1 - Version 6
+            //****************************************************************
+            /**
+             * @brief Adds all elements of a range to a container, sequentially or in parallel.
+             *
+             * With koncar::execution::seq this is exactly Version 3. With koncar::execution::par, large random access
+             * ranges appended to resizable random access containers (std::vector, std::deque, koncar::small_vector, ...)
+             * are copied (or moved, for owning rvalue ranges) by several threads.
+             *
+             * @tparam Container The type of container to which elements will be added.
+             * @tparam Range The type of the input range.
+             * @param policy The execution policy, with its parallel threshold, grain and thread limit.
+             * @param container The container to which elements will be added.
+             * @param range The range whose elements will be added to the container.
+             *
+             * @details Standard containers cannot construct into uninitialized storage from several threads, so instead
+             * of copy- or move-constructing the new elements, the container is resized once (default-constructing the
+             * tail) and disjoint slices of the tail are then copy- or move-assigned in parallel; contiguous trivially
+             * copyable slices are copied with memcpy. Below `policy.threshold` elements, or when the scheme does not
+             * apply, the call falls back to Version 3: for element types which are not default-constructible and for
+             * proxy-reference containers such as std::vector<bool>, whose neighbouring slices share storage words.
+             * If a slice throws, the container is shrunk back to its original size and the exception is rethrown.
+             *
+             * Example usage:
+             * \code{.cpp}
+             * std::vector<record> merged;
+             * for (const auto& shard : shards)
+             *     koncar::add_range(koncar::execution::par, merged, shard);
+             * \endcode
+             */
+            template <typename Container, typename Range>
+                requires appendable_range<Container, Range>
+            void operator()(const execution::sequenced_policy&, Container&& container, Range&& range) const {
+                (*this)(container, std::forward<Range>(range));
+            }
+
+            template <typename Container, typename Range>
+                requires appendable_range<Container, Range>
+            void operator()(const execution::parallel_policy& policy, Container&& container, Range&& range) const {
+                using container_type = std::remove_reference_t<Container>;
+                if constexpr (parallel_appendable<container_type, Range>) {
+                    const auto count = static_cast<std::size_t>(std::ranges::size(range));
+                    if (count >= policy.threshold) {
+                        const std::size_t offset = container.size();
+                        container.resize(offset + count);
+                        try {
+                            const auto source = std::ranges::begin(range);
+                            const auto destination = std::ranges::begin(container) + offset;
+                            parallel_slices(count, policy, [&](const std::size_t first, const std::size_t last) {
+                                if constexpr (memcpy_compatible<Range, element_t<Container>> && std::ranges::contiguous_range<container_type>)
+                                    std::memcpy(std::to_address(destination + first), std::ranges::data(range) + first, (last - first) * sizeof(element_t<Container>));
+                                else if constexpr (owning_rvalue<Range>)
+                                    std::ranges::move(source + first, source + last, destination + first);
+                                else
+                                    std::ranges::copy(source + first, source + last, destination + first);
+                            });
+                        } catch (...) {
+                            container.resize(offset);
+                            throw;
+                        }
+                        return;
+                    }
+                }
+                (*this)(container, std::forward<Range>(range));
+            }
+
+        private:
+            // Hands a whole range to the container's own add_range if there is one, and to append_range otherwise
+            template <typename Container, typename Range>
+            static void append_all(Container& container, Range&& range) {
+                if constexpr (custom_add_range<Container, Range>)
+                    add_range(container, std::forward<Range>(range));
+                else
+                    detail::append_range(container, std::forward<Range>(range));
+            }
+        };
+
+    }
+
+    // Task 1 - Customization point
     //****************************************************************
     /**
-     * @brief Converts binary data to a hexadecimal string representation.
+     * @brief Adds elements to any container using the fastest operation the container offers.
      *
-     * This function takes a vector of binary data and converts it into a hexadecimal string representation.
-     * Each byte in the input vector is converted to its hexadecimal representation and concatenated to form the output string.
-     * If an error occurs during the conversion process, an exception of type std::exception is thrown.
-     * The function handles the exception and returns an empty string to indicate failure.
+     * koncar::add_range is a customization point object: one generic call site works with sequences
+     * (std::vector, std::string, std::deque, std::list, ...), ordered and unordered associative containers,
+     * front-only containers (std::forward_list) and fixed-capacity containers, and the strategy is selected
+     * at compile time. The available overloads are documented on detail::add_range_fn (Task 1, Versions 1-5).
      *
-     * @param data The vector of binary data to be converted to a hexadecimal string.
-     * @param uppercase Optional flag indicating whether the resulting hexadecimal string should be in uppercase (default is true).
-     * @return A hexadecimal string representation of the input binary data, or an empty string if conversion fails.
+     * @details A container type can take over completely by providing a free function
+     * `add_range(Container&, ...)` in its own namespace, usually as a hidden friend. It is found by
+     * argument-dependent lookup and receives exactly the arguments passed to koncar::add_range,
+     * except that braced lists are forwarded as a range.
      *
-     * @details This function iterates through each byte in the input vector, converts it to hexadecimal,
-     * and appends it to the output string. The resulting string contains the hexadecimal representation of the binary data.
-     * Optionally, the function allows specifying whether the hexadecimal characters should be in uppercase.
-     * Any errors encountered during the conversion process are caught and handled.
+     * Example usage:
+     * \code{.cpp}
+     * std::unordered_set<int> set;
+     * koncar::add_range(set, std::vector<int>{ 1, 2, 3 }); // one rehash, then insert(first, last)
+     *
+     * namespace sensors {
+     *     class ring_buffer {
+     *         // ...
+     *         friend void add_range(ring_buffer& ring, auto&&... samples) { ring.push_batch(samples...); }
+     *     };
+     * }
+     * \endcode
+     */
+    inline namespace cpo {
+        inline constexpr detail::add_range_fn add_range{};
+    }
+    
+    // Trivially relocatable types
+    //****************************************************************
+    /**
+     * @brief Opt-in trait for types whose objects can be moved to new storage with memcpy, without running
+     * the move constructor on the destination and the destructor on the source.
+     *
+     * @tparam T The type to query.
+     *
+     * @details Trivially copyable types are trivially relocatable, and so are std::unique_ptr with a trivially
+     * relocatable deleter and std::pair of trivially relocatable types. std::shared_ptr and std::weak_ptr are only
+     * treated as relocatable on libstdc++, whose implementation (an element pointer and a control block pointer,
+     * nothing pointing back at the object) was checked; the standard does not promise it.
+     * Other types opt in by specializing the trait. That is correct when no object stores a pointer into itself
+     * or is registered by address elsewhere (std::string with a small-string buffer is not relocatable, for example).
+     * koncar::small_vector and koncar::static_vector move such elements with memcpy/memmove when they grow,
+     * insert or erase, and small_vector grows its heap block in place with std::realloc.
      *
      * Example usage:
      * \code{.cpp}
-     * const std::vector<uint8_t> binary_data = { 0xBA, 0xAD, 0xF0, 0x0D };
-     * const std::string hex_string = koncar::binary_to_string(binary_data);
-     * // hex_string contains "BAADF00D"
+     * struct handle { std::unique_ptr<resource> owner; std::uint32_t id; };
+     *
+     * template <>
+     * struct koncar::is_trivially_relocatable<handle> : std::true_type {};
      * \endcode
      */
-    std::string binary_to_string(const std::vector<uint8_t>& data, const bool uppercase = true) {
-        try {
-            std::ostringstream oss;
-            oss << std::hex << std::setfill('0');
-            if (uppercase)
-                oss << std::uppercase;
-            for (const auto byte : data)
-                oss << std::setw(2) << static_cast<int>(byte);
-            return oss.str();
-        } catch (const std::exception& e) {
-            // Handle the exception
-            std::cerr << "Error: " << e.what() << std::endl;
-            // Return an empty string to indicate failure
-            return "";
+    template <typename T>
+    struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+    template <typename T, typename Deleter>
+    struct is_trivially_relocatable<std::unique_ptr<T, Deleter>> : is_trivially_relocatable<Deleter> {};
+
+#ifdef __GLIBCXX__
+    // Relies on the libstdc++ layout of two plain pointers; other standard libraries keep the conservative default
+    template <typename T>
+    struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+    template <typename T>
+    struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+#endif
+
+    template <typename First, typename Second>
+    struct is_trivially_relocatable<std::pair<First, Second>>
+        : std::bool_constant<is_trivially_relocatable<First>::value && is_trivially_relocatable<Second>::value> {};
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+    
+    // Containers - Concurrent append buffer
+    //****************************************************************
+    /**
+     * @brief A multi-producer, single-consumer append buffer whose producers never take a lock.
+     *
+     * Elements live in segmented storage: segment k holds `first_segment_size << k` slots, so the buffer grows
+     * without ever moving an element. A producer makes sure the segments of the slots it is about to claim exist,
+     * claims the slots with a single compare-and-swap on the reservation counter, constructs its elements in place
+     * and publishes every slot with a release store. Segments are allocated on first use and installed with
+     * a compare-and-swap; a producer which loses the race frees its own allocation. A failed allocation therefore
+     * claims nothing, and a throwing constructor abandons its own slot and every later slot of its batch, so the
+     * consumer skips them instead of waiting for them forever.
+     *
+     * @tparam T The type of elements stored in the buffer.
+     *
+     * @details koncar::add_range(buffer, a, b, c) claims all three slots with one atomic operation, and so do
+     * sized ranges and braced lists. The consumer removes elements in index order with
+     * `consume` or `drain`; a slot whose element is still being constructed stops the drain until its producer
+     * publishes it. Only one thread may consume at a time, and `clear` must not run concurrently with anything.
+     * Slots are not reused: the buffer is an append-only log whose memory is released by `clear` or the destructor.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::concurrent_append_buffer<record> buffer;
+     * // any number of producer threads
+     * koncar::add_range(buffer, record_a, record_b, record_c);
+     * // consumer thread
+     * std::vector<record> batch;
+     * buffer.drain(batch);
+     * \endcode
+     */
+    template <typename T>
+    class concurrent_append_buffer {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+        static constexpr size_type first_segment_size = 64;
+
+        concurrent_append_buffer() = default;
+        concurrent_append_buffer(const concurrent_append_buffer&) = delete;
+        concurrent_append_buffer& operator=(const concurrent_append_buffer&) = delete;
+
+        ~concurrent_append_buffer() {
+            clear();
+        }
+
+        /**
+         * @brief Constructs one element at the end of the buffer.
+         * @return The index of the new element.
+         */
+        template <typename... Args>
+        size_type emplace_back(Args&&... args) {
+            const size_type index = claim(1);
+            construct(index, std::forward<Args>(args)...);
+            return index;
+        }
+
+        size_type push_back(const T& value) {
+            return emplace_back(value);
+        }
+
+        size_type push_back(T&& value) {
+            return emplace_back(std::move(value));
+        }
+
+        /**
+         * @brief Constructs one element from each argument, claiming all of the slots with a single atomic operation.
+         * @return The index of the first new element.
+         */
+        template <typename... Args>
+        size_type emplace_batch(Args&&... args) {
+            const size_type first = claim(sizeof...(Args));
+            size_type index = first;
+            try {
+                ((construct(index, std::forward<Args>(args)), ++index), ...);
+            } catch (...) {
+                abandon(index, first + sizeof...(Args));
+                throw;
+            }
+            return first;
+        }
+
+        /**
+         * @brief Moves every published element, in index order, into `consumer` and destroys it.
+         *
+         * Stops at the first slot which has been claimed but not yet published.
+         *
+         * @param consumer Callable invoked with `T&&` for every element.
+         * @return The number of elements consumed.
+         */
+        template <typename Consumer>
+        size_type consume(Consumer&& consumer) {
+            const size_type first = read_.load(std::memory_order_relaxed);
+            const size_type last = published_end(first);
+            size_type index = first;
+            try {
+                for (; index < last; ++index) {
+                    slot& current = slot_at(index);
+                    if (current.state.load(std::memory_order_relaxed) == slot_ready) {
+                        T* element = std::launder(reinterpret_cast<T*>(current.storage));
+                        consumer(std::move(*element));
+                        element->~T();
+                    }
+                }
+            } catch (...) {
+                // The element which made the consumer throw is dropped, the rest stays in the buffer
+                std::launder(reinterpret_cast<T*>(slot_at(index).storage))->~T();
+                read_.store(index + 1, std::memory_order_release);
+                throw;
+            }
+            read_.store(last, std::memory_order_release);
+            return last - first;
+        }
+
+        /**
+         * @brief Moves every published element into `container` using koncar::add_range strategies.
+         *
+         * The container is prepared once for the whole batch (one allocation for reservable sequences).
+         *
+         * @return The number of elements moved into the container.
+         */
+        template <typename Container>
+        size_type drain(Container& container) {
+            detail::prepare(container, published_end(read_.load(std::memory_order_relaxed)) - read_.load(std::memory_order_relaxed));
+            detail::appender<Container> append(container);
+            return consume([&](T&& element) { append(std::move(element)); });
+        }
+
+        /**
+         * @brief Returns the number of claimed slots, including elements which are not published yet.
+         */
+        size_type size() const noexcept {
+            return claimed_.load(std::memory_order_acquire) - read_.load(std::memory_order_acquire);
+        }
+
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        /**
+         * @brief Destroys all remaining elements and releases all segments. Not thread safe.
+         */
+        void clear() {
+            const size_type last = claimed_.load(std::memory_order_acquire);
+            for (size_type index = read_.load(std::memory_order_relaxed); index < last; ++index) {
+                slot* segment = segments_[segment_of(index)].load(std::memory_order_acquire);
+                if (segment && segment[offset_of(index)].state.load(std::memory_order_acquire) == slot_ready)
+                    std::launder(reinterpret_cast<T*>(segment[offset_of(index)].storage))->~T();
+            }
+            for (auto& segment : segments_)
+                delete[] segment.exchange(nullptr, std::memory_order_acq_rel);
+            claimed_.store(0, std::memory_order_release);
+            read_.store(0, std::memory_order_release);
+        }
+
+        /**
+         * @brief koncar::add_range customization: claims the slots for all arguments with one atomic operation.
+         */
+        template <typename... Args>
+        friend void add_range(concurrent_append_buffer& buffer, Args&&... args) {
+            buffer.emplace_batch(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief koncar::add_range customization for ranges: multi-pass ranges claim all of their slots at once.
+         */
+        template <typename Range>
+            requires detail::appendable_range<concurrent_append_buffer, Range>
+        friend void add_range(concurrent_append_buffer& buffer, Range&& range) {
+            if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>) {
+                const size_type count = static_cast<size_type>(std::ranges::distance(range));
+                const size_type first = buffer.claim(count);
+                size_type index = first;
+                try {
+                    for (auto it = std::ranges::begin(range); it != std::ranges::end(range); ++it, ++index) {
+                        if constexpr (detail::owning_rvalue<Range>)
+                            buffer.construct(index, std::ranges::iter_move(it));
+                        else
+                            buffer.construct(index, *it);
+                    }
+                } catch (...) {
+                    buffer.abandon(index, first + count);
+                    throw;
+                }
+            } else {
+                for (auto&& element : range)
+                    buffer.emplace_back(std::forward<decltype(element)>(element));
+            }
+        }
+
+    private:
+        enum : std::uint8_t { slot_empty, slot_ready, slot_abandoned };
+
+        struct slot {
+            std::atomic<std::uint8_t> state{ slot_empty };
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        static constexpr unsigned first_segment_bits = std::countr_zero(first_segment_size);
+        static constexpr unsigned max_segments = std::numeric_limits<size_type>::digits - first_segment_bits;
+
+        // Segment k starts at index first_segment_size * (2^k - 1)
+        static unsigned segment_of(const size_type index) noexcept {
+            return static_cast<unsigned>(std::bit_width(index + first_segment_size)) - 1 - first_segment_bits;
+        }
+
+        static size_type offset_of(const size_type index) noexcept {
+            return index + first_segment_size - (first_segment_size << segment_of(index));
+        }
+
+        // Reserves `count` consecutive slots whose segments all exist. The segments are allocated before the slots
+        // are claimed, so bad_alloc leaves no claimed slot behind which nobody would ever publish.
+        size_type claim(const size_type count) {
+            size_type first = claimed_.load(std::memory_order_relaxed);
+            for (;;) {
+                if (count) {
+                    const unsigned last_segment = segment_of(first + count - 1);
+                    for (unsigned segment = segment_of(first); segment <= last_segment; ++segment)
+                        allocate_segment(segment);
+                }
+                if (claimed_.compare_exchange_weak(first, first + count, std::memory_order_relaxed))
+                    return first;
+            }
+        }
+
+        void allocate_segment(const unsigned segment) {
+            if (segments_[segment].load(std::memory_order_acquire))
+                return;
+            slot* fresh = new slot[first_segment_size << segment];
+            slot* expected = nullptr;
+            if (!segments_[segment].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel))
+                delete[] fresh;
+        }
+
+        slot& slot_at(const size_type index) const noexcept {
+            return segments_[segment_of(index)].load(std::memory_order_acquire)[offset_of(index)];
+        }
+
+        // Constructs the element of a claimed slot and publishes it; a throwing constructor abandons the slot
+        template <typename... Args>
+        void construct(const size_type index, Args&&... args) {
+            slot& target = slot_at(index);
+            try {
+                ::new (static_cast<void*>(target.storage)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                target.state.store(slot_abandoned, std::memory_order_release);
+                throw;
+            }
+            target.state.store(slot_ready, std::memory_order_release);
+        }
+
+        // Marks the claimed slots [first, last), whose elements were never constructed, as abandoned
+        void abandon(size_type first, const size_type last) noexcept {
+            for (; first < last; ++first)
+                slot_at(first).state.store(slot_abandoned, std::memory_order_release);
+        }
+
+        // Returns the end of the run of published (or abandoned) slots starting at `index`
+        size_type published_end(size_type index) const noexcept {
+            const size_type last = claimed_.load(std::memory_order_acquire);
+            while (index < last) {
+                slot* segment = segments_[segment_of(index)].load(std::memory_order_acquire);
+                if (!segment || segment[offset_of(index)].state.load(std::memory_order_acquire) == slot_empty)
+                    break;
+                ++index;
+            }
+            return index;
+        }
+
+        std::array<std::atomic<slot*>, max_segments> segments_{};
+        alignas(64) std::atomic<size_type> claimed_{ 0 };
+        alignas(64) std::atomic<size_type> read_{ 0 };
+    };
+    
+    // Containers - Ring buffer
+    //****************************************************************
+    /**
+     * @brief A bounded lock-free ring buffer for one consumer and one or many producers.
+     *
+     * The capacity is rounded up to a power of two and allocated once. The producer indices, the consumer index
+     * and the read-only storage description live on separate cache lines, and each side caches the other side's
+     * index so that a batch normally touches the shared lines only once. Several producers share one cached copy
+     * of the consumer index and read the consumer's line only when the ring looks full.
+     *
+     * @tparam T The type of elements stored in the buffer.
+     * @tparam MultiProducer Whether several threads may push concurrently (MPSC) or only one (SPSC).
+     *
+     * @details koncar::add_range(ring, a, b, c) and koncar::add_range(ring, range) construct the whole batch
+     * in place and publish it as a whole, waiting for free space while the ring is full.
+     * A range larger than the capacity is published in ring-sized batches. `try_push` and `try_push_range`
+     * never wait. The consumer receives published elements as contiguous spans from `peek_batch` and returns
+     * them with `release`, or uses `consume`/`drain`.
+     *
+     * A single producer publishes a batch by advancing the tail with one release store. With several producers,
+     * a producer claims its slots with a compare-and-swap and marks each slot published, the last slot first, so
+     * the consumer sees the batch whole once it reaches its first slot. The consumer takes the run of published
+     * slots from its position on, so batches arrive in claim order and never interleave. A producer which is slow
+     * to fill its slots holds back later batches from the consumer, but no producer ever waits for another.
+     * Element construction must not throw in that mode, because claimed slots cannot be handed back. A single
+     * producer publishes the elements constructed before an exception and rethrows it.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::spsc_ring_buffer<sample> ring(4096);
+     * // acquisition thread
+     * koncar::add_range(ring, samples); // one release store per batch
+     * // processing thread
+     * while (auto batch = ring.peek_batch(); !batch.empty()) {
+     *     process(batch);
+     *     ring.release(batch.size());
+     * }
+     * \endcode
+     */
+    template <typename T, bool MultiProducer = false>
+    class ring_buffer {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+        static constexpr bool multi_producer = MultiProducer;
+
+        /**
+         * @brief Allocates storage for at least `capacity` elements.
+         * @throws std::length_error If `capacity` is zero or too large.
+         */
+        explicit ring_buffer(const size_type capacity) {
+            if (capacity == 0 || capacity > (std::numeric_limits<size_type>::max() / sizeof(T) + 1) / 2)
+                throw std::length_error("ring_buffer: invalid capacity");
+            mask_ = std::bit_ceil(capacity) - 1;
+            if constexpr (MultiProducer)
+                published_ = std::make_unique<std::atomic<bool>[]>(mask_ + 1);
+            storage_ = static_cast<T*>(::operator new((mask_ + 1) * sizeof(T), std::align_val_t{ alignof(T) }));
+        }
+
+        ring_buffer(const ring_buffer&) = delete;
+        ring_buffer& operator=(const ring_buffer&) = delete;
+
+        ~ring_buffer() {
+            release(size());
+            ::operator delete(storage_, std::align_val_t{ alignof(T) });
+        }
+
+        size_type capacity() const noexcept {
+            return mask_ + 1;
+        }
+
+        /**
+         * @brief Returns the number of published elements not yet released by the consumer.
+         *
+         * With several producers the count also includes claimed slots whose elements are still being constructed.
+         */
+        size_type size() const noexcept {
+            const size_type head = head_.load(std::memory_order_acquire);
+            if constexpr (MultiProducer)
+                return claimed_.load(std::memory_order_acquire) - head;
+            else
+                return tail_.load(std::memory_order_acquire) - head;
+        }
+
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        /**
+         * @brief Constructs one element if there is free space, without waiting.
+         * @return Whether the element was pushed.
+         */
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            const size_type first = claim(1, 1, false).first;
+            if (first == npos)
+                return false;
+            publish(first, construct_batch(first, std::forward<Args>(args)...));
+            return true;
+        }
+
+        bool try_push(const T& value) {
+            return try_emplace(value);
+        }
+
+        bool try_push(T&& value) {
+            return try_emplace(std::move(value));
+        }
+
+        /**
+         * @brief Pushes as many leading elements of a sized or forward range as currently fit, without waiting.
+         * @return The number of elements pushed, published together.
+         */
+        template <std::ranges::input_range Range>
+            requires std::ranges::sized_range<Range> || std::ranges::forward_range<Range>
+        size_type try_push_range(Range&& range) {
+            const size_type count = static_cast<size_type>(std::ranges::distance(range));
+            if (count == 0)
+                return 0;
+            const auto [first, claimed] = claim(1, count, false);
+            if (first == npos)
+                return 0;
+            auto it = std::ranges::begin(range);
+            publish(first, construct_range<detail::owning_rvalue<Range>>(first, claimed, it));
+            return claimed;
+        }
+
+        /**
+         * @brief Constructs one element from each argument and publishes them together, waiting for free space.
+         * @throws std::length_error If the batch is larger than the capacity.
+         */
+        template <typename... Args>
+        void emplace_batch(Args&&... args) {
+            if constexpr (sizeof...(Args) > 0) {
+                if (sizeof...(Args) > capacity())
+                    throw std::length_error("ring_buffer: batch larger than capacity");
+                const size_type first = claim(sizeof...(Args), sizeof...(Args), true).first;
+                publish(first, construct_batch(first, std::forward<Args>(args)...));
+            }
+        }
+
+        /**
+         * @brief Pushes every element of a range, waiting for free space.
+         *
+         * Sized and forward ranges are published in batches as large as the free space allows;
+         * single-pass ranges of unknown size are published element by element.
+         */
+        template <std::ranges::input_range Range>
+        void push_range(Range&& range) {
+            if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>) {
+                size_type remaining = static_cast<size_type>(std::ranges::distance(range));
+                auto it = std::ranges::begin(range);
+                while (remaining) {
+                    const auto [first, claimed] = claim(1, std::min(remaining, capacity()), true);
+                    publish(first, construct_range<detail::owning_rvalue<Range>>(first, claimed, it));
+                    remaining -= claimed;
+                }
+            } else {
+                for (auto&& element : range)
+                    emplace_batch(std::forward<decltype(element)>(element));
+            }
+        }
+
+        /**
+         * @brief Returns the longest contiguous run of published elements, at most `max_count` of them.
+         *
+         * The elements stay in the buffer until the consumer calls `release`; they may be modified or moved from.
+         * A run that wraps around the end of the storage is returned by two successive calls. Consumer only.
+         */
+        std::span<T> peek_batch(const size_type max_count = npos) noexcept {
+            const size_type head = head_.load(std::memory_order_relaxed);
+            const size_type offset = head & mask_;
+            const size_type limit = std::min(capacity() - offset, max_count);
+            size_type count = 0;
+            if constexpr (MultiProducer) {
+                while (count < limit && published_[offset + count].load(std::memory_order_acquire))
+                    ++count;
+            } else {
+                if (cached_tail_ == head)
+                    cached_tail_ = tail_.load(std::memory_order_acquire);
+                count = std::min(cached_tail_ - head, limit);
+            }
+            return { storage_ + offset, count };
+        }
+
+        /**
+         * @brief Destroys the first `count` published elements and hands their slots back to the producers.
+         * @param count At most the number of elements returned by previous `peek_batch` calls. Consumer only.
+         */
+        void release(size_type count) noexcept {
+            const size_type head = head_.load(std::memory_order_relaxed);
+            if constexpr (!std::is_trivially_destructible_v<T> || MultiProducer) {
+                for (size_type index = head; index != head + count; ++index) {
+                    if constexpr (!std::is_trivially_destructible_v<T>)
+                        std::launder(storage_ + (index & mask_))->~T();
+                    if constexpr (MultiProducer)
+                        published_[index & mask_].store(false, std::memory_order_relaxed);
+                }
+            }
+            head_.store(head + count, std::memory_order_release);
+        }
+
+        /**
+         * @brief Moves every published element, in order, into `consumer` and releases it.
+         *
+         * @param consumer Callable invoked with `T&&` for every element.
+         * @return The number of elements consumed.
+         */
+        template <typename Consumer>
+        size_type consume(Consumer&& consumer) {
+            size_type total = 0;
+            for (std::span<T> batch = peek_batch(); !batch.empty(); batch = peek_batch()) {
+                size_type done = 0;
+                try {
+                    for (; done < batch.size(); ++done)
+                        consumer(std::move(batch[done]));
+                } catch (...) {
+                    // The element which made the consumer throw is dropped, the rest stays in the buffer
+                    release(done + 1);
+                    throw;
+                }
+                release(batch.size());
+                total += batch.size();
+            }
+            return total;
+        }
+
+        /**
+         * @brief Moves every published element into `container` using koncar::add_range strategies.
+         *
+         * The container is prepared once for the whole batch (one allocation for reservable sequences).
+         *
+         * @return The number of elements moved into the container.
+         */
+        template <typename Container>
+        size_type drain(Container& container) {
+            detail::prepare(container, size());
+            detail::appender<Container> append(container);
+            return consume([&](T&& element) { append(std::move(element)); });
+        }
+
+        /**
+         * @brief koncar::add_range customization: the arguments are published as one batch.
+         */
+        template <typename... Args>
+        friend void add_range(ring_buffer& ring, Args&&... args) {
+            ring.emplace_batch(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief koncar::add_range customization for ranges: each ring-sized batch is published as a whole.
+         */
+        template <typename Range>
+            requires detail::appendable_range<ring_buffer, Range>
+        friend void add_range(ring_buffer& ring, Range&& range) {
+            ring.push_range(std::forward<Range>(range));
+        }
+
+    private:
+        static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+        // Claims between `min_count` and `max_count` consecutive slots, {npos, 0} if they are not free and `wait` is false
+        std::pair<size_type, size_type> claim(const size_type min_count, const size_type max_count, const bool wait) {
+            if constexpr (MultiProducer) {
+                size_type first = claimed_.load(std::memory_order_relaxed);
+                for (;;) {
+                    size_type free = free_space(first, cached_head_.load(std::memory_order_acquire));
+                    if (free < min_count)
+                        free = free_space(first, refresh_head());
+                    if (free < min_count) {
+                        if (!wait)
+                            return { npos, 0 };
+                        std::this_thread::yield();
+                        first = claimed_.load(std::memory_order_relaxed);
+                        continue;
+                    }
+                    const size_type count = std::min(free, max_count);
+                    if (claimed_.compare_exchange_weak(first, first + count, std::memory_order_relaxed))
+                        return { first, count };
+                }
+            } else {
+                const size_type first = tail_.load(std::memory_order_relaxed);
+                while (capacity() - (first - cached_head_) < min_count) {
+                    cached_head_ = head_.load(std::memory_order_acquire);
+                    if (capacity() - (first - cached_head_) >= min_count)
+                        break;
+                    if (!wait)
+                        return { npos, 0 };
+                    std::this_thread::yield();
+                }
+                return { first, std::min(capacity() - (first - cached_head_), max_count) };
+            }
+        }
+
+        // Free slots after `first` as seen from `head`; none when the two indices were read out of step
+        size_type free_space(const size_type first, const size_type head) const noexcept {
+            const size_type used = first - head;
+            return used < capacity() ? capacity() - used : 0;
+        }
+
+        // Reads the consumer index and advances the producers' shared copy to it. Multi-producer only.
+        size_type refresh_head() noexcept {
+            const size_type head = head_.load(std::memory_order_acquire);
+            size_type cached = cached_head_.load(std::memory_order_relaxed);
+            while (cached < head && !cached_head_.compare_exchange_weak(cached, head, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+            return head;
+        }
+
+        // Makes the constructed slots [first, first + count) visible to the consumer
+        void publish(const size_type first, const size_type count) noexcept {
+            if constexpr (MultiProducer) {
+                // The first slot is marked last, so the consumer never sees part of the batch
+                for (size_type index = first + count; index != first;)
+                    published_[(--index) & mask_].store(true, std::memory_order_release);
+            } else {
+                tail_.store(first + count, std::memory_order_release);
+            }
+        }
+
+        template <typename Arg>
+        static constexpr bool nothrow_from = !MultiProducer || std::is_nothrow_constructible_v<T, Arg>;
+
+        // Constructs one element per argument from slot `first` on and returns the number constructed
+        template <typename... Args>
+        size_type construct_batch(const size_type first, Args&&... args) {
+            static_assert((nothrow_from<Args&&> && ...), "ring_buffer: elements of a multi-producer ring must be nothrow constructible");
+            size_type done = 0;
+            try {
+                ((::new (static_cast<void*>(storage_ + ((first + done) & mask_))) T(std::forward<Args>(args)), ++done), ...);
+            } catch (...) {
+                publish(first, done);
+                throw;
+            }
+            return done;
+        }
+
+        // Constructs `count` elements from `it` onwards, advancing `it`, and returns the number constructed
+        template <bool Move, typename Iterator>
+        size_type construct_range(const size_type first, const size_type count, Iterator& it) {
+            using source = std::conditional_t<Move, std::iter_rvalue_reference_t<Iterator>, std::iter_reference_t<Iterator>>;
+            static_assert(nothrow_from<source>, "ring_buffer: elements of a multi-producer ring must be nothrow constructible");
+            size_type done = 0;
+            try {
+                for (; done < count; ++done, ++it) {
+                    T* slot = storage_ + ((first + done) & mask_);
+                    if constexpr (Move)
+                        ::new (static_cast<void*>(slot)) T(std::ranges::iter_move(it));
+                    else
+                        ::new (static_cast<void*>(slot)) T(*it);
+                }
+            } catch (...) {
+                publish(first, done);
+                throw;
+            }
+            return done;
+        }
+
+        struct empty_index {};
+
+        // Producer side: the single producer's published end or the producers' claim counter, and their view of the head
+        alignas(64) std::conditional_t<MultiProducer, empty_index, std::atomic<size_type>> tail_{};
+        alignas(64) std::conditional_t<MultiProducer, std::atomic<size_type>, empty_index> claimed_{};
+        std::conditional_t<MultiProducer, std::atomic<size_type>, size_type> cached_head_{};
+
+        // Consumer side
+        alignas(64) std::atomic<size_type> head_{ 0 };
+        std::conditional_t<MultiProducer, empty_index, size_type> cached_tail_{};
+
+        // Read-only after construction (the flags themselves are written by both sides)
+        alignas(64) T* storage_ = nullptr;
+        size_type mask_ = 0;
+        std::conditional_t<MultiProducer, std::unique_ptr<std::atomic<bool>[]>, empty_index> published_{};
+    };
+
+    template <typename T>
+    using spsc_ring_buffer = ring_buffer<T, false>;
+
+    template <typename T>
+    using mpsc_ring_buffer = ring_buffer<T, true>;
+    
+    // Containers - Segmented vector
+    //****************************************************************
+    /**
+     * @brief A random access sequence stored in fixed-size chunks, so elements never move once constructed.
+     *
+     * Elements live in chunks of `ChunkSize` elements (a power of two). Growing the container allocates new chunks
+     * and never relocates existing elements, so references, pointers and iterators to elements stay valid.
+     * Appending is amortized O(1): only the table of chunk pointers, one pointer per chunk, is ever reallocated.
+     * Element `i` lives in chunk `i >> log2(ChunkSize)` at offset `i & (ChunkSize - 1)`, so indexing costs a shift,
+     * a mask and one indirection. Iterators hold the chunk table of their container and an index, so they survive
+     * growth as well.
+     *
+     * @tparam T The type of elements stored in the container.
+     * @tparam ChunkSize The number of elements per chunk; by default chunks are about 64 KiB.
+     *
+     * @details segmented_vector is a first-class koncar::add_range target: `reserve` allocates all chunks needed
+     * by a batch at once (and, unlike std::vector, never over-allocates because growth does not relocate), and
+     * `append_range` copies contiguous trivially copyable input chunk by chunk with memcpy.
+     * Contiguous runs of elements are exposed through `chunk(k)` for cache-friendly bulk processing.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::segmented_vector<event> events;
+     * koncar::add_range(events, incoming_events);
+     * const event& first = events[0]; // stays valid no matter how many events are appended later
+     * \endcode
+     */
+    template <typename T, std::size_t ChunkSize = std::bit_floor(std::max<std::size_t>(16, 65536 / sizeof(T)))>
+    class segmented_vector {
+        static_assert(std::has_single_bit(ChunkSize), "segmented_vector chunk size must be a power of two");
+
+        template <bool Const>
+        class basic_iterator {
+        public:
+            using iterator_concept = std::random_access_iterator_tag;
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const T*, T*>;
+            using reference = std::conditional_t<Const, const T&, T&>;
+
+            basic_iterator() = default;
+            basic_iterator(const std::vector<T*>* chunks, const std::size_t index) : chunks_(chunks), index_(index) {}
+
+            template <bool OtherConst>
+                requires (Const && !OtherConst)
+            basic_iterator(const basic_iterator<OtherConst>& other) : chunks_(other.chunks_), index_(other.index_) {}
+
+            reference operator*() const { return (*chunks_)[index_ >> chunk_bits][index_ & chunk_mask]; }
+            pointer operator->() const { return &**this; }
+            reference operator[](const difference_type n) const { return *(*this + n); }
+
+            basic_iterator& operator++() { ++index_; return *this; }
+            basic_iterator operator++(int) { auto copy = *this; ++index_; return copy; }
+            basic_iterator& operator--() { --index_; return *this; }
+            basic_iterator operator--(int) { auto copy = *this; --index_; return copy; }
+            basic_iterator& operator+=(const difference_type n) { index_ += n; return *this; }
+            basic_iterator& operator-=(const difference_type n) { index_ -= n; return *this; }
+
+            friend basic_iterator operator+(basic_iterator it, const difference_type n) { return it += n; }
+            friend basic_iterator operator+(const difference_type n, basic_iterator it) { return it += n; }
+            friend basic_iterator operator-(basic_iterator it, const difference_type n) { return it -= n; }
+            friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) {
+                return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+            }
+            friend bool operator==(const basic_iterator& a, const basic_iterator& b) { return a.index_ == b.index_; }
+            friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) { return a.index_ <=> b.index_; }
+
+        private:
+            friend class basic_iterator<!Const>;
+
+            // The table itself, not its data: the table reallocates when chunks are added
+            const std::vector<T*>* chunks_ = nullptr;
+            std::size_t index_ = 0;
+        };
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        static constexpr size_type chunk_size = ChunkSize;
+        static constexpr bool stable_references = true;
+
+        segmented_vector() = default;
+
+        segmented_vector(std::initializer_list<T> values) {
+            append_range(values);
+        }
+
+        segmented_vector(const segmented_vector& other) {
+            append_range(other);
+        }
+
+        segmented_vector(segmented_vector&& other) noexcept
+            : chunks_(std::move(other.chunks_)), size_(std::exchange(other.size_, 0)) {}
+
+        segmented_vector& operator=(segmented_vector other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        ~segmented_vector() {
+            clear();
+            for (T* chunk : chunks_)
+                deallocate_chunk(chunk);
+        }
+
+        void swap(segmented_vector& other) noexcept {
+            chunks_.swap(other.chunks_);
+            std::swap(size_, other.size_);
+        }
+
+        friend void swap(segmented_vector& a, segmented_vector& b) noexcept {
+            a.swap(b);
+        }
+
+        size_type size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+        size_type capacity() const noexcept { return chunks_.size() * chunk_size; }
+
+        /**
+         * @brief Allocates all chunks needed to hold `count` elements. Existing elements are never moved.
+         */
+        void reserve(const size_type count) {
+            const size_type required_chunks = (count + chunk_size - 1) / chunk_size;
+            if (required_chunks <= chunks_.size())
+                return;
+            chunks_.reserve(required_chunks);
+            while (chunks_.size() < required_chunks)
+                chunks_.push_back(allocate_chunk());
+        }
+
+        /**
+         * @brief Releases chunks which hold no elements.
+         */
+        void shrink_to_fit() {
+            const size_type used_chunks = (size_ + chunk_size - 1) / chunk_size;
+            while (chunks_.size() > used_chunks) {
+                deallocate_chunk(chunks_.back());
+                chunks_.pop_back();
+            }
+            chunks_.shrink_to_fit();
+        }
+
+        template <typename... Args>
+        reference emplace_back(Args&&... args) {
+            if (size_ == capacity())
+                chunks_.push_back(allocate_chunk());
+            T* element = ::new (static_cast<void*>(address(size_))) T(std::forward<Args>(args)...);
+            ++size_;
+            return *element;
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+
+        void pop_back() {
+            --size_;
+            address(size_)->~T();
+        }
+
+        /**
+         * @brief Appends all elements of `range`, allocating every chunk the range needs at once.
+         *
+         * Contiguous ranges of trivially copyable elements are copied with one memcpy per destination chunk,
+         * and elements of owning rvalue ranges are moved.
+         */
+        template <std::ranges::input_range Range>
+        void append_range(Range&& range) {
+            if constexpr (detail::memcpy_compatible<Range, T>) {
+                const T* source = std::ranges::data(range);
+                size_type remaining = static_cast<size_type>(std::ranges::size(range));
+                reserve(size_ + remaining);
+                while (remaining) {
+                    const size_type count = std::min(remaining, chunk_size - (size_ & chunk_mask));
+                    std::memcpy(static_cast<void*>(address(size_)), source, count * sizeof(T));
+                    size_ += count;
+                    source += count;
+                    remaining -= count;
+                }
+            } else {
+                if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>)
+                    reserve(size_ + static_cast<size_type>(std::ranges::distance(range)));
+                for (auto it = std::ranges::begin(range); it != std::ranges::end(range); ++it) {
+                    if constexpr (detail::owning_rvalue<Range>)
+                        emplace_back(std::ranges::iter_move(it));
+                    else
+                        emplace_back(*it);
+                }
+            }
+        }
+
+        /**
+         * @brief Destroys all elements. The chunks are kept for reuse, see shrink_to_fit.
+         */
+        void clear() noexcept {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (size_type index = 0; index < size_; ++index)
+                    address(index)->~T();
+            }
+            size_ = 0;
+        }
+
+        reference operator[](const size_type index) { return *address(index); }
+        const_reference operator[](const size_type index) const { return *address(index); }
+
+        reference at(const size_type index) {
+            check_index(index);
+            return *address(index);
+        }
+
+        const_reference at(const size_type index) const {
+            check_index(index);
+            return *address(index);
+        }
+
+        reference front() { return *address(0); }
+        const_reference front() const { return *address(0); }
+        reference back() { return *address(size_ - 1); }
+        const_reference back() const { return *address(size_ - 1); }
+
+        /**
+         * @brief Returns the number of chunks which hold at least one element.
+         */
+        size_type chunk_count() const noexcept { return (size_ + chunk_size - 1) / chunk_size; }
+
+        /**
+         * @brief Returns the elements stored contiguously in chunk `k`.
+         */
+        std::span<T> chunk(const size_type k) noexcept {
+            return { chunks_[k], std::min(chunk_size, size_ - k * chunk_size) };
+        }
+
+        std::span<const T> chunk(const size_type k) const noexcept {
+            return { chunks_[k], std::min(chunk_size, size_ - k * chunk_size) };
+        }
+
+        iterator begin() noexcept { return { &chunks_, 0 }; }
+        iterator end() noexcept { return { &chunks_, size_ }; }
+        const_iterator begin() const noexcept { return { &chunks_, 0 }; }
+        const_iterator end() const noexcept { return { &chunks_, size_ }; }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+    private:
+        static constexpr unsigned chunk_bits = std::countr_zero(ChunkSize);
+        static constexpr size_type chunk_mask = ChunkSize - 1;
+
+        static T* allocate_chunk() {
+            return static_cast<T*>(::operator new(chunk_size * sizeof(T), std::align_val_t{ alignof(T) }));
+        }
+
+        static void deallocate_chunk(T* chunk) noexcept {
+            ::operator delete(chunk, std::align_val_t{ alignof(T) });
+        }
+
+        T* address(const size_type index) const noexcept {
+            return chunks_[index >> chunk_bits] + (index & chunk_mask);
+        }
+
+        void check_index(const size_type index) const {
+            if (index >= size_)
+                throw std::out_of_range("segmented_vector index " + std::to_string(index) + " out of range");
+        }
+
+        std::vector<T*> chunks_;
+        size_type size_ = 0;
+    };
+    
+    // Containers - Small and static vectors
+    //****************************************************************
+    namespace detail {
+
+        // Exposes the compile-time capacity of containers which can never grow (see add_range_fn)
+        template <std::size_t N, bool Growable>
+        struct capacity_limit {};
+
+        template <std::size_t N>
+        struct capacity_limit<N, false> {
+            static constexpr std::size_t static_capacity = N;
+        };
+
+        /**
+         * @brief Contiguous sequence with storage for N elements inside the object itself.
+         *
+         * Shared implementation of koncar::small_vector (Growable, spills to the heap when the inline storage
+         * is exhausted) and koncar::static_vector (never allocates, throws std::length_error on overflow).
+         * The interface follows std::vector, and iterators are plain pointers.
+         */
+        template <typename T, std::size_t N, bool Growable>
+        class inline_vector : public capacity_limit<N, Growable> {
+            static_assert(N > 0, "inline_vector needs room for at least one element");
+
+        public:
+            using value_type = T;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using reference = T&;
+            using const_reference = const T&;
+            using pointer = T*;
+            using const_pointer = const T*;
+            using iterator = T*;
+            using const_iterator = const T*;
+
+            static constexpr size_type inline_capacity = N;
+
+            inline_vector() noexcept = default;
+
+            explicit inline_vector(const size_type count) {
+                resize(count);
+            }
+
+            inline_vector(const size_type count, const T& value) {
+                assign(count, value);
+            }
+
+            template <std::input_iterator I, std::sentinel_for<I> S>
+            inline_vector(I first, S last) {
+                insert(end(), std::move(first), std::move(last));
+            }
+
+            inline_vector(std::initializer_list<T> values) {
+                insert(end(), values.begin(), values.end());
+            }
+
+            inline_vector(const inline_vector& other) {
+                reserve_exact(other.size_);
+                std::uninitialized_copy(other.begin(), other.end(), data_);
+                size_ = other.size_;
+            }
+
+            inline_vector(inline_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+                take(std::move(other));
+            }
+
+            inline_vector& operator=(const inline_vector& other) {
+                if (this != &other)
+                    assign(other.begin(), other.end());
+                return *this;
+            }
+
+            inline_vector& operator=(inline_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+                if (this != &other) {
+                    clear();
+                    release_heap();
+                    take(std::move(other));
+                }
+                return *this;
+            }
+
+            inline_vector& operator=(std::initializer_list<T> values) {
+                assign(values.begin(), values.end());
+                return *this;
+            }
+
+            ~inline_vector() {
+                clear();
+                release_heap();
+            }
+
+            void assign(const size_type count, const T& value) {
+                clear();
+                insert(end(), count, value);
+            }
+
+            template <std::input_iterator I, std::sentinel_for<I> S>
+            void assign(I first, S last) {
+                clear();
+                insert(end(), std::move(first), std::move(last));
+            }
+
+            size_type size() const noexcept { return size_; }
+            bool empty() const noexcept { return size_ == 0; }
+            size_type capacity() const noexcept { return capacity_; }
+            size_type max_size() const noexcept { return max_elements; }
+
+            // True while the elements live in the inline storage
+            bool is_inline() const noexcept { return data_ == inline_data(); }
+
+            void reserve(const size_type count) requires Growable {
+                if (count > capacity_) {
+                    check_length(count);
+                    reallocate(count);
+                }
+            }
+
+            void shrink_to_fit() requires Growable {
+                if (!is_inline() && size_ < capacity_)
+                    reallocate(size_);
+            }
+
+            T* data() noexcept { return data_; }
+            const T* data() const noexcept { return data_; }
+
+            iterator begin() noexcept { return data_; }
+            iterator end() noexcept { return data_ + size_; }
+            const_iterator begin() const noexcept { return data_; }
+            const_iterator end() const noexcept { return data_ + size_; }
+            const_iterator cbegin() const noexcept { return begin(); }
+            const_iterator cend() const noexcept { return end(); }
+
+            reference operator[](const size_type index) { return data_[index]; }
+            const_reference operator[](const size_type index) const { return data_[index]; }
+
+            reference at(const size_type index) {
+                check_index(index);
+                return data_[index];
+            }
+
+            const_reference at(const size_type index) const {
+                check_index(index);
+                return data_[index];
+            }
+
+            reference front() { return data_[0]; }
+            const_reference front() const { return data_[0]; }
+            reference back() { return data_[size_ - 1]; }
+            const_reference back() const { return data_[size_ - 1]; }
+
+            template <typename... Args>
+            reference emplace_back(Args&&... args) {
+                if (size_ == capacity_)
+                    return grow_and_emplace_back(std::forward<Args>(args)...);
+                T* element = std::construct_at(data_ + size_, std::forward<Args>(args)...);
+                ++size_;
+                return *element;
+            }
+
+            void push_back(const T& value) { emplace_back(value); }
+            void push_back(T&& value) { emplace_back(std::move(value)); }
+
+            void pop_back() {
+                std::destroy_at(data_ + --size_);
+            }
+
+            template <typename... Args>
+            iterator emplace(const_iterator position, Args&&... args) {
+                const size_type index = static_cast<size_type>(position - data_);
+                if (index == size_) {
+                    emplace_back(std::forward<Args>(args)...);
+                } else if constexpr (relocatable) {
+                    // The new element may alias an element of this vector, so it is built before anything moves
+                    alignas(T) unsigned char staged[sizeof(T)];
+                    T* const value = std::construct_at(reinterpret_cast<T*>(staged), std::forward<Args>(args)...);
+                    try {
+                        ensure_room(1);
+                    } catch (...) {
+                        std::destroy_at(value);
+                        throw;
+                    }
+                    move_bytes(data_ + index + 1, data_ + index, size_ - index);
+                    move_bytes(data_ + index, value, 1);
+                    ++size_;
+                } else {
+                    // The new element may alias an element of this vector, so it is built before anything moves
+                    T value(std::forward<Args>(args)...);
+                    emplace_back(std::move(back()));
+                    std::move_backward(data_ + index, data_ + size_ - 2, data_ + size_ - 1);
+                    data_[index] = std::move(value);
+                }
+                return data_ + index;
+            }
+
+            iterator insert(const_iterator position, const T& value) { return emplace(position, value); }
+            iterator insert(const_iterator position, T&& value) { return emplace(position, std::move(value)); }
+
+            iterator insert(const_iterator position, const size_type count, const T& value) {
+                const size_type index = static_cast<size_type>(position - data_);
+                const T copy(value);
+                ensure_room(count);
+                if constexpr (relocatable) {
+                    open_gap(index, count, [&](T* gap) { std::uninitialized_fill_n(gap, count, copy); });
+                } else {
+                    std::uninitialized_fill_n(data_ + size_, count, copy);
+                    size_ += count;
+                    std::rotate(data_ + index, data_ + size_ - count, data_ + size_);
+                }
+                return data_ + index;
+            }
+
+            template <std::input_iterator I, std::sentinel_for<I> S>
+            iterator insert(const_iterator position, I first, S last) {
+                const size_type index = static_cast<size_type>(position - data_);
+                const size_type old_size = size_;
+                if constexpr (std::forward_iterator<I>) {
+                    const size_type count = static_cast<size_type>(std::ranges::distance(first, last));
+                    ensure_room(count);
+                    if constexpr (relocatable) {
+                        open_gap(index, count, [&](T* gap) { std::ranges::uninitialized_copy(first, last, gap, gap + count); });
+                        return data_ + index;
+                    }
+                }
+                for (; first != last; ++first)
+                    emplace_back(*first);
+                std::rotate(data_ + index, data_ + old_size, data_ + size_);
+                return data_ + index;
+            }
+
+            iterator insert(const_iterator position, std::initializer_list<T> values) {
+                return insert(position, values.begin(), values.end());
+            }
+
+            iterator erase(const_iterator position) {
+                return erase(position, position + 1);
+            }
+
+            iterator erase(const_iterator first, const_iterator last) {
+                T* const from = data_ + (first - data_);
+                T* const to = data_ + (last - data_);
+                if (from != to && relocatable) {
+                    std::destroy(from, to);
+                    move_bytes(from, to, static_cast<size_type>(data_ + size_ - to));
+                    size_ -= static_cast<size_type>(to - from);
+                } else if (from != to) {
+                    T* const new_end = std::move(to, data_ + size_, from);
+                    std::destroy(new_end, data_ + size_);
+                    size_ = static_cast<size_type>(new_end - data_);
+                }
+                return from;
+            }
+
+            void resize(const size_type count) {
+                resize_with(count, [this] { std::uninitialized_value_construct_n(data_ + size_, 1); });
+            }
+
+            void resize(const size_type count, const T& value) {
+                resize_with(count, [&] { std::construct_at(data_ + size_, value); });
+            }
+
+            void clear() noexcept {
+                std::destroy(data_, data_ + size_);
+                size_ = 0;
+            }
+
+            void swap(inline_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+                inline_vector temporary(std::move(other));
+                other = std::move(*this);
+                *this = std::move(temporary);
+            }
+
+            friend void swap(inline_vector& a, inline_vector& b) noexcept(std::is_nothrow_move_constructible_v<T>) {
+                a.swap(b);
+            }
+
+            friend bool operator==(const inline_vector& a, const inline_vector& b) {
+                return std::equal(a.begin(), a.end(), b.begin(), b.end());
+            }
+
+        private:
+            static constexpr bool relocatable = is_trivially_relocatable_v<T>;
+
+            static constexpr size_type max_elements = Growable ? std::numeric_limits<difference_type>::max() / sizeof(T) : N;
+
+            // Heap blocks of relocatable elements come from malloc, so growth can extend them in place with realloc
+            static constexpr bool uses_realloc = Growable && relocatable && alignof(T) <= alignof(std::max_align_t);
+
+            T* inline_data() noexcept { return reinterpret_cast<T*>(buffer_); }
+            const T* inline_data() const noexcept { return reinterpret_cast<const T*>(buffer_); }
+
+            void check_index(const size_type index) const {
+                if (index >= size_)
+                    throw std::out_of_range("inline_vector index " + std::to_string(index) + " out of range");
+            }
+
+            [[noreturn]] static void throw_overflow() {
+                throw std::length_error("static_vector capacity of " + std::to_string(N) + " elements exceeded");
+            }
+
+            // Like std::vector, refuses sizes whose byte count would not fit in a ptrdiff_t
+            static void check_length(const size_type count) {
+                if (count > max_elements)
+                    throw std::length_error("small_vector of " + std::to_string(count) + " elements exceeds max_size()");
+            }
+
+            // Reserve which never over-allocates, used where the final size is known
+            void reserve_exact(const size_type count) {
+                if (count > capacity_) {
+                    if constexpr (Growable) {
+                        check_length(count);
+                        reallocate(count);
+                    } else {
+                        throw_overflow();
+                    }
+                }
+            }
+
+            // Capacity for `extra` more elements: at least double the current one, saturated at max_size()
+            size_type grown_capacity(const size_type extra) const {
+                if (extra > max_elements - size_)
+                    throw std::length_error("small_vector cannot grow beyond max_size()");
+                const size_type doubled = capacity_ > max_elements / 2 ? max_elements : capacity_ * 2;
+                return std::max(size_ + extra, doubled);
+            }
+
+            // Makes room for `extra` more elements, growing geometrically
+            void ensure_room(const size_type extra) {
+                if (extra > capacity_ - size_) {
+                    if constexpr (Growable)
+                        reallocate(grown_capacity(extra));
+                    else
+                        throw_overflow();
+                }
+            }
+
+            // Moves the elements to fresh storage for `new_capacity` elements (back to inline storage if they fit)
+            void reallocate(const size_type new_capacity) {
+                if constexpr (uses_realloc) {
+                    if (!is_inline() && new_capacity > N) {
+                        check_length(new_capacity);
+                        void* const block = std::realloc(static_cast<void*>(data_), new_capacity * sizeof(T));
+                        if (!block)
+                            throw std::bad_alloc();
+                        data_ = static_cast<T*>(block);
+                        capacity_ = new_capacity;
+                        return;
+                    }
+                }
+                T* const new_data = new_capacity <= N ? inline_data() : allocate(new_capacity);
+                if (new_data == data_)
+                    return;
+                relocate(data_, size_, new_data);
+                release_heap();
+                data_ = new_data;
+                capacity_ = std::max(new_capacity, N);
+            }
+
+            template <typename... Args>
+            reference grow_and_emplace_back(Args&&... args) {
+                if constexpr (uses_realloc) {
+                    // Construct the new element first, since the arguments may refer to elements of this vector,
+                    // then let realloc extend the block and put the element behind the existing ones
+                    alignas(T) unsigned char staged[sizeof(T)];
+                    T* const value = std::construct_at(reinterpret_cast<T*>(staged), std::forward<Args>(args)...);
+                    try {
+                        reallocate(grown_capacity(1));
+                    } catch (...) {
+                        std::destroy_at(value);
+                        throw;
+                    }
+                    move_bytes(data_ + size_, value, 1);
+                    return data_[size_++];
+                } else if constexpr (Growable) {
+                    // Construct the new element first, since the arguments may refer to elements of this vector
+                    const size_type new_capacity = grown_capacity(1);
+                    T* const new_data = allocate(new_capacity);
+                    try {
+                        std::construct_at(new_data + size_, std::forward<Args>(args)...);
+                    } catch (...) {
+                        deallocate(new_data, new_capacity);
+                        throw;
+                    }
+                    relocate(data_, size_, new_data);
+                    release_heap();
+                    data_ = new_data;
+                    capacity_ = new_capacity;
+                    return data_[size_++];
+                } else {
+                    throw_overflow();
+                }
+            }
+
+            template <typename Construct>
+            void resize_with(const size_type count, Construct construct) {
+                if (count < size_) {
+                    std::destroy(data_ + count, data_ + size_);
+                    size_ = count;
+                    return;
+                }
+                reserve_exact(count);
+                while (size_ < count) {
+                    construct();
+                    ++size_;
+                }
+            }
+
+            // Relocates `count` trivially relocatable elements with memmove; the source is left as raw storage
+            static void move_bytes(T* destination, const T* source, const size_type count) noexcept {
+                if (count)
+                    std::memmove(static_cast<void*>(destination), static_cast<const void*>(source), count * sizeof(T));
+            }
+
+            // Relocates the elements from `index` on by `count` slots, lets `construct` fill the gap and closes it again
+            // if that throws. The capacity must already be sufficient. Trivially relocatable elements only.
+            template <typename Construct>
+            void open_gap(const size_type index, const size_type count, Construct construct) {
+                move_bytes(data_ + index + count, data_ + index, size_ - index);
+                try {
+                    construct(data_ + index);
+                } catch (...) {
+                    move_bytes(data_ + index, data_ + index + count, size_ - index);
+                    throw;
+                }
+                size_ += count;
+            }
+
+            // Moves `count` elements from `source` to uninitialized `destination` and destroys the originals
+            static void relocate(T* source, const size_type count, T* destination) {
+                if constexpr (relocatable) {
+                    move_bytes(destination, source, count);
+                } else {
+                    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>)
+                        std::uninitialized_move(source, source + count, destination);
+                    else
+                        std::uninitialized_copy(source, source + count, destination);
+                    std::destroy(source, source + count);
+                }
+            }
+
+            // Adopts the contents of `other`, stealing its heap block when it has one, and leaves it empty
+            void take(inline_vector&& other) {
+                if (!other.is_inline()) {
+                    data_ = std::exchange(other.data_, other.inline_data());
+                    capacity_ = std::exchange(other.capacity_, N);
+                    size_ = std::exchange(other.size_, 0);
+                } else if constexpr (relocatable) {
+                    relocate(other.data_, other.size_, data_);
+                    size_ = std::exchange(other.size_, 0);
+                } else {
+                    std::uninitialized_move(other.begin(), other.end(), data_);
+                    size_ = other.size_;
+                    other.clear();
+                }
+            }
+
+            static T* allocate(const size_type count) {
+                check_length(count);
+                if constexpr (uses_realloc) {
+                    if (void* const block = std::malloc(count * sizeof(T)))
+                        return static_cast<T*>(block);
+                    throw std::bad_alloc();
+                } else {
+                    return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{ alignof(T) }));
+                }
+            }
+
+            static void deallocate(T* block, const size_type) noexcept {
+                if constexpr (uses_realloc)
+                    std::free(block);
+                else
+                    ::operator delete(block, std::align_val_t{ alignof(T) });
+            }
+
+            void release_heap() noexcept {
+                if (!is_inline()) {
+                    deallocate(data_, capacity_);
+                    data_ = inline_data();
+                    capacity_ = N;
+                }
+            }
+
+            T* data_ = inline_data();
+            size_type size_ = 0;
+            size_type capacity_ = N;
+            alignas(T) unsigned char buffer_[N * sizeof(T)];
+        };
+
+    }
+
+    /**
+     * @brief A vector which keeps up to N elements inside the object and spills to the heap beyond that.
+     *
+     * Short-lived vectors filled with a handful of elements by koncar::add_range never touch the heap:
+     * add_range reserves for the whole batch, which is free while the batch fits into the inline storage.
+     * Once spilled, small_vector grows geometrically like std::vector.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::small_vector<int, 8> vector;
+     * koncar::add_range(vector, 1, 2, 3, 4, 5);
+     * // vector now contains {1, 2, 3, 4, 5} and vector.is_inline() is true
+     * \endcode
+     */
+    template <typename T, std::size_t N>
+    using small_vector = detail::inline_vector<T, N, true>;
+
+    /**
+     * @brief A vector with a fixed capacity of N elements which never allocates.
+     *
+     * Exceeding the capacity throws std::length_error. koncar::add_range checks the whole batch before adding
+     * anything, and rejects at compile time (static_assert) a batch of arguments which can never fit.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::static_vector<int, 4> vector;
+     * koncar::add_range(vector, 1, 2, 3);
+     * // koncar::add_range(vector, 1, 2, 3, 4, 5); would not compile
+     * \endcode
+     */
+    template <typename T, std::size_t N>
+    using static_vector = detail::inline_vector<T, N, false>;
+    
+    // Containers - Structure of arrays
+    //****************************************************************
+    namespace detail {
+
+        // Satisfied by std::tuple, std::pair, std::array and other types supporting std::tuple_size/std::get
+        template <typename T>
+        concept tuple_like = requires { std::tuple_size<std::remove_cvref_t<T>>::value; };
+
+        // Converts to anything; used to count the members of an aggregate
+        struct any_field {
+            template <typename T>
+            operator T() const;
+        };
+
+        template <typename Aggregate, std::size_t... I>
+        constexpr bool brace_constructible_from(std::index_sequence<I...>) {
+            return requires { Aggregate{ (void(I), any_field{})... }; };
+        }
+
+        // Satisfied by a tuple-like type with N elements or an aggregate with exactly N members
+        template <typename Record, std::size_t N>
+        concept record_of = (tuple_like<Record> && std::tuple_size<std::remove_cvref_t<Record>>::value == N)
+            || (std::is_aggregate_v<std::remove_cvref_t<Record>> && !tuple_like<Record>
+                && brace_constructible_from<std::remove_cvref_t<Record>>(std::make_index_sequence<N>{})
+                && !brace_constructible_from<std::remove_cvref_t<Record>>(std::make_index_sequence<N + 1>{}));
+
+        /**
+         * @brief Calls `function` with the N fields of `record`, which is either tuple-like or an aggregate with N members.
+         *
+         * Fields of an rvalue record are passed as rvalues, so they can be moved out of it.
+         * Aggregates are decomposed with structured bindings, which supports up to 8 members.
+         */
+        template <std::size_t N, typename Record, typename Function>
+        decltype(auto) apply_fields(Record&& record, Function&& function) {
+            if constexpr (tuple_like<Record>) {
+                static_assert(std::tuple_size_v<std::remove_cvref_t<Record>> == N, "record has the wrong number of fields");
+                return std::apply(std::forward<Function>(function), std::forward<Record>(record));
+            } else {
+                static_assert(N >= 1 && N <= 8, "aggregate records are supported with 1 to 8 members");
+                // Forwards a member with the value category of the record
+                auto fwd = []<typename Member>(Member& member) -> decltype(auto) {
+                    if constexpr (std::is_lvalue_reference_v<Record>)
+                        return static_cast<Member&>(member);
+                    else
+                        return static_cast<Member&&>(member);
+                };
+                if constexpr (N == 1) {
+                    auto&& [a] = record;
+                    return function(fwd(a));
+                } else if constexpr (N == 2) {
+                    auto&& [a, b] = record;
+                    return function(fwd(a), fwd(b));
+                } else if constexpr (N == 3) {
+                    auto&& [a, b, c] = record;
+                    return function(fwd(a), fwd(b), fwd(c));
+                } else if constexpr (N == 4) {
+                    auto&& [a, b, c, d] = record;
+                    return function(fwd(a), fwd(b), fwd(c), fwd(d));
+                } else if constexpr (N == 5) {
+                    auto&& [a, b, c, d, e] = record;
+                    return function(fwd(a), fwd(b), fwd(c), fwd(d), fwd(e));
+                } else if constexpr (N == 6) {
+                    auto&& [a, b, c, d, e, f] = record;
+                    return function(fwd(a), fwd(b), fwd(c), fwd(d), fwd(e), fwd(f));
+                } else if constexpr (N == 7) {
+                    auto&& [a, b, c, d, e, f, g] = record;
+                    return function(fwd(a), fwd(b), fwd(c), fwd(d), fwd(e), fwd(f), fwd(g));
+                } else if constexpr (N == 8) {
+                    auto&& [a, b, c, d, e, f, g, h] = record;
+                    return function(fwd(a), fwd(b), fwd(c), fwd(d), fwd(e), fwd(f), fwd(g), fwd(h));
+                }
+            }
+        }
+
+    }
+
+    /**
+     * @brief A sequence of records stored as a structure of arrays: every field lives in its own contiguous column.
+     *
+     * Scanning a single field of many records touches only that field's column, instead of dragging whole records
+     * through the cache. Columns are exposed as std::span, ready for vectorized kernels.
+     *
+     * @tparam Fields The field types of a record, in order.
+     *
+     * @details Records are added either field by field with `emplace_back(fields...)`, or as whole records with
+     * `push_back(record)`, where a record is a tuple-like object (std::tuple, std::pair, ...) or an aggregate struct
+     * with the same number of members. koncar::add_range reserves every column once and then scatters the incoming
+     * records into the columns in a single pass.
+     * If constructing a field throws, the fields already added for that record are removed again,
+     * so all columns always have the same length.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * struct sample { uint64_t timestamp; double value; uint8_t channel; };
+     * koncar::soa_vector<uint64_t, double, uint8_t> samples;
+     * koncar::add_range(samples, incoming_samples);           // std::vector<sample>
+     * const std::span<const double> values = samples.column<1>();
+     * const double total = std::reduce(values.begin(), values.end());
+     * \endcode
+     */
+    template <typename... Fields>
+    class soa_vector {
+        static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+        static_assert((!std::is_same_v<Fields, bool> && ...), "std::vector<bool> columns cannot be exposed as spans, use uint8_t");
+
+    public:
+        using value_type = std::tuple<Fields...>;
+        using size_type = std::size_t;
+        using reference = std::tuple<Fields&...>;
+        using const_reference = std::tuple<const Fields&...>;
+
+        template <std::size_t I>
+        using field_type = std::tuple_element_t<I, value_type>;
+
+        static constexpr std::size_t field_count = sizeof...(Fields);
+
+        size_type size() const noexcept { return std::get<0>(columns_).size(); }
+        bool empty() const noexcept { return size() == 0; }
+
+        size_type capacity() const noexcept {
+            return std::apply([](const auto&... column) { return std::min({ column.capacity()... }); }, columns_);
+        }
+
+        void reserve(const size_type count) {
+            std::apply([count](auto&... column) { (column.reserve(count), ...); }, columns_);
+        }
+
+        void clear() noexcept {
+            std::apply([](auto&... column) { (column.clear(), ...); }, columns_);
+        }
+
+        void pop_back() {
+            std::apply([](auto&... column) { (column.pop_back(), ...); }, columns_);
+        }
+
+        /**
+         * @brief Appends one record given field by field.
+         */
+        template <typename... Args>
+            requires (sizeof...(Args) == sizeof...(Fields) && (std::constructible_from<Fields, Args> && ...))
+        void emplace_back(Args&&... args) {
+            emplace_fields(std::index_sequence_for<Fields...>{}, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Appends one record given as a tuple-like object or an aggregate, scattering its fields into the columns.
+         */
+        template <detail::record_of<sizeof...(Fields)> Record>
+        void push_back(Record&& record) {
+            detail::apply_fields<sizeof...(Fields)>(std::forward<Record>(record), [this]<typename... Args>(Args&&... fields) {
+                emplace_fields(std::index_sequence_for<Fields...>{}, std::forward<Args>(fields)...);
+            });
+        }
+
+        /**
+         * @brief Appends all records of `range`, reserving every column once for sized ranges.
+         */
+        template <std::ranges::input_range Range>
+        void append_range(Range&& range) {
+            if constexpr (std::ranges::sized_range<Range> || std::ranges::forward_range<Range>)
+                reserve(size() + static_cast<size_type>(std::ranges::distance(range)));
+            for (auto it = std::ranges::begin(range); it != std::ranges::end(range); ++it) {
+                if constexpr (detail::owning_rvalue<Range>)
+                    push_back(std::ranges::iter_move(it));
+                else
+                    push_back(*it);
+            }
+        }
+
+        /**
+         * @brief Returns field I of every record as one contiguous span.
+         */
+        template <std::size_t I>
+        std::span<field_type<I>> column() noexcept { return std::get<I>(columns_); }
+
+        template <std::size_t I>
+        std::span<const field_type<I>> column() const noexcept { return std::get<I>(columns_); }
+
+        // Field I of record `index`
+        template <std::size_t I>
+        field_type<I>& get(const size_type index) { return std::get<I>(columns_)[index]; }
+
+        template <std::size_t I>
+        const field_type<I>& get(const size_type index) const { return std::get<I>(columns_)[index]; }
+
+        // References to all fields of record `index`
+        reference operator[](const size_type index) {
+            return std::apply([index](auto&... column) { return reference(column[index]...); }, columns_);
+        }
+
+        const_reference operator[](const size_type index) const {
+            return std::apply([index](const auto&... column) { return const_reference(column[index]...); }, columns_);
+        }
+
+    private:
+        template <std::size_t... I, typename... Args>
+        void emplace_fields(std::index_sequence<I...>, Args&&... args) {
+            std::size_t added = 0;
+            try {
+                ((std::get<I>(columns_).emplace_back(std::forward<Args>(args)), ++added), ...);
+            } catch (...) {
+                ((I < added ? std::get<I>(columns_).pop_back() : void()), ...);
+                throw;
+            }
+        }
+
+        std::tuple<std::vector<Fields>...> columns_;
+    };
+    
+    // Containers - Flat set and map
+    //****************************************************************
+    namespace detail {
+
+        struct key_identity {
+            template <typename Value>
+            const Value& operator()(const Value& value) const noexcept {
+                return value;
+            }
+        };
+
+        struct key_first {
+            template <typename Value>
+            const auto& operator()(const Value& value) const noexcept {
+                return value.first;
+            }
+        };
+
+        /**
+         * @brief A sorted, duplicate-free std::vector shared by koncar::flat_set and koncar::flat_map.
+         *
+         * @tparam Value The stored element type.
+         * @tparam Key The type elements are ordered by.
+         * @tparam KeyOf Projection from an element to its key.
+         * @tparam Compare Strict weak ordering of keys.
+         *
+         * @details Bulk insertion (`insert_range` and koncar::add_range) appends the batch after a geometric
+         * reserve, stable-sorts only the batch, drops batch elements whose key is already present or repeated,
+         * and merges the remainder into place with std::inplace_merge. Only elements greater than the smallest new key
+         * take part in the merge, so a batch of k elements costs O(n + k log k) instead of re-sorting all n + k
+         * elements, and a batch that sorts after every existing key costs O(k log k). The merge uses the standard
+         * library's temporary buffer when it can get one and an O(m log m) merge without extra memory otherwise. Among equivalent elements the one already in the
+         * container wins, then the first one in the batch, as with std::set::insert.
+         *
+         * If an exception is thrown while a batch is sorted or merged, the container is cleared.
+         */
+        template <typename Value, typename Key, typename KeyOf, typename Compare>
+        class flat_tree {
+        public:
+            using key_type = Key;
+            using value_type = Value;
+            using key_compare = Compare;
+            using container_type = std::vector<Value>;
+            using size_type = std::size_t;
+            using const_iterator = typename container_type::const_iterator;
+            // Keys must not be modified through an iterator, so a set only hands out const iterators
+            using iterator = std::conditional_t<std::is_same_v<Key, Value>, const_iterator, typename container_type::iterator>;
+
+            flat_tree() = default;
+
+            explicit flat_tree(const Compare& compare) : compare_(compare) {}
+
+            flat_tree(std::initializer_list<Value> values, const Compare& compare = Compare()) : compare_(compare) {
+                insert_range(values);
+            }
+
+            iterator begin() noexcept { return values_.begin(); }
+            iterator end() noexcept { return values_.end(); }
+            const_iterator begin() const noexcept { return values_.begin(); }
+            const_iterator end() const noexcept { return values_.end(); }
+            const_iterator cbegin() const noexcept { return values_.cbegin(); }
+            const_iterator cend() const noexcept { return values_.cend(); }
+
+            size_type size() const noexcept { return values_.size(); }
+            bool empty() const noexcept { return values_.empty(); }
+            size_type capacity() const noexcept { return values_.capacity(); }
+            void reserve(const size_type capacity) { values_.reserve(capacity); }
+            void shrink_to_fit() { values_.shrink_to_fit(); }
+            void clear() noexcept { values_.clear(); }
+
+            key_compare key_comp() const { return compare_; }
+
+            /**
+             * @brief Inserts one element unless an element with an equivalent key is present.
+             * @return The position of the element with that key and whether the insertion took place.
+             */
+            template <typename... Args>
+            std::pair<iterator, bool> emplace(Args&&... args) {
+                Value value(std::forward<Args>(args)...);
+                const auto position = lower_bound_of(values_, KeyOf{}(value));
+                if (position != values_.end() && !compare_(KeyOf{}(value), KeyOf{}(*position)))
+                    return { position, false };
+                return { values_.insert(position, std::move(value)), true };
+            }
+
+            std::pair<iterator, bool> insert(const Value& value) {
+                return emplace(value);
+            }
+
+            std::pair<iterator, bool> insert(Value&& value) {
+                return emplace(std::move(value));
+            }
+
+            /**
+             * @brief Inserts every element of a range with one sort of the range and one linear merge.
+             */
+            template <std::ranges::input_range Range>
+            void insert_range(Range&& range) {
+                const size_type old_size = values_.size();
+                try {
+                    detail::append_range(values_, std::forward<Range>(range));
+                } catch (...) {
+                    values_.erase(values_.begin() + old_size, values_.end());
+                    throw;
+                }
+                merge_tail(old_size);
+            }
+
+            iterator erase(const_iterator position) {
+                return values_.erase(position);
+            }
+
+            iterator erase(const_iterator first, const_iterator last) {
+                return values_.erase(first, last);
+            }
+
+            size_type erase(const Key& key) {
+                const auto position = find_in(values_, key);
+                if (position == values_.end())
+                    return 0;
+                values_.erase(position);
+                return 1;
+            }
+
+            iterator find(const Key& key) { return find_in(values_, key); }
+            const_iterator find(const Key& key) const { return find_in(values_, key); }
+            iterator lower_bound(const Key& key) { return lower_bound_of(values_, key); }
+            const_iterator lower_bound(const Key& key) const { return lower_bound_of(values_, key); }
+            iterator upper_bound(const Key& key) { return std::ranges::upper_bound(values_, key, compare_, KeyOf{}); }
+            const_iterator upper_bound(const Key& key) const { return std::ranges::upper_bound(values_, key, compare_, KeyOf{}); }
+
+            bool contains(const Key& key) const {
+                return find(key) != end();
+            }
+
+            size_type count(const Key& key) const {
+                return contains(key) ? 1 : 0;
+            }
+
+            /**
+             * @brief Moves the sorted underlying vector out of the container, leaving it empty.
+             */
+            container_type extract() && {
+                container_type values = std::move(values_);
+                values_.clear();
+                return values;
+            }
+
+            friend bool operator==(const flat_tree& lhs, const flat_tree& rhs) {
+                return lhs.values_ == rhs.values_;
+            }
+
+            /**
+             * @brief koncar::add_range customization: appends the arguments and merges them in as one batch.
+             */
+            template <typename... Args>
+            friend void add_range(flat_tree& tree, Args&&... args) {
+                const size_type old_size = tree.values_.size();
+                detail::prepare(tree.values_, sizeof...(Args));
+                try {
+                    (tree.values_.emplace_back(std::forward<Args>(args)), ...);
+                } catch (...) {
+                    tree.values_.erase(tree.values_.begin() + old_size, tree.values_.end());
+                    throw;
+                }
+                tree.merge_tail(old_size);
+            }
+
+            /**
+             * @brief koncar::add_range customization for ranges, equivalent to `insert_range`.
+             */
+            template <typename Range>
+                requires detail::appendable_range<flat_tree, Range>
+            friend void add_range(flat_tree& tree, Range&& range) {
+                tree.insert_range(std::forward<Range>(range));
+            }
+
+        protected:
+            template <typename Values>
+            auto lower_bound_of(Values& values, const Key& key) const {
+                return std::ranges::lower_bound(values, key, compare_, KeyOf{});
+            }
+
+            template <typename Values>
+            auto find_in(Values& values, const Key& key) const {
+                const auto position = lower_bound_of(values, key);
+                return position != values.end() && !compare_(key, KeyOf{}(*position)) ? position : values.end();
+            }
+
+            container_type values_;
+            [[no_unique_address]] Compare compare_{};
+
+        private:
+            // Sorts the elements appended after `old_size`, drops the ones whose key is already present and merges the rest into place
+            void merge_tail(const size_type old_size) {
+                const auto less = [this](const Value& lhs, const Value& rhs) { return compare_(KeyOf{}(lhs), KeyOf{}(rhs)); };
+                try {
+                    const auto middle = values_.begin() + old_size;
+                    std::stable_sort(middle, values_.end(), less);
+
+                    // Keep the first of equivalent new elements, unless the key is already in the container.
+                    // The search start only moves forward, so the lookups stay within O(n + k log k) in total.
+                    auto kept = middle;
+                    auto probe = values_.begin();
+                    for (auto it = middle; it != values_.end(); ++it) {
+                        if (kept != middle && !less(*(kept - 1), *it))
+                            continue;
+                        probe = std::lower_bound(probe, middle, *it, less);
+                        if (probe != middle && !less(*it, *probe))
+                            continue;
+                        if (kept != it)
+                            *kept = std::move(*it);
+                        ++kept;
+                    }
+                    values_.erase(kept, values_.end());
+
+                    const auto first_new = values_.begin() + old_size;
+                    if (first_new == values_.begin() || first_new == values_.end() || less(*(first_new - 1), *first_new))
+                        return;
+
+                    // Merge in place; old elements before the smallest new one stay where they are
+                    const auto displaced = std::upper_bound(values_.begin(), first_new, *first_new, less);
+                    std::inplace_merge(displaced, first_new, values_.end(), less);
+                } catch (...) {
+                    values_.clear();
+                    throw;
+                }
+            }
+        };
+
+    }
+
+    /**
+     * @brief A set stored as a sorted std::vector, with O(n + k log k) bulk insertion.
+     *
+     * @tparam Key The type of elements stored in the set.
+     * @tparam Compare Strict weak ordering of the elements.
+     *
+     * @details Lookups are binary searches over contiguous memory. koncar::add_range and `insert_range` sort only
+     * the incoming batch and merge it in linearly; see detail::flat_tree for the exact costs and guarantees.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::flat_set<int> set{ 1, 5, 9 };
+     * koncar::add_range(set, std::vector<int>{ 7, 3, 5, 3 }); // set is { 1, 3, 5, 7, 9 }
+     * \endcode
+     */
+    template <typename Key, typename Compare = std::less<Key>>
+    class flat_set : public detail::flat_tree<Key, Key, detail::key_identity, Compare> {
+    public:
+        using detail::flat_tree<Key, Key, detail::key_identity, Compare>::flat_tree;
+    };
+
+    /**
+     * @brief A map stored as a sorted std::vector of key-value pairs, with O(n + k log k) bulk insertion.
+     *
+     * @tparam Key The type of keys.
+     * @tparam T The type of mapped values.
+     * @tparam Compare Strict weak ordering of the keys.
+     *
+     * @details Elements are `std::pair<Key, T>`; the key of an element must not be modified through an iterator.
+     * Bulk insertion keeps the existing value of a key that is already present, like std::map::insert.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::flat_map<std::string, int> map;
+     * koncar::add_range(map, std::pair{ std::string("b"), 2 }, std::pair{ std::string("a"), 1 });
+     * map["c"] = 3;
+     * \endcode
+     */
+    template <typename Key, typename T, typename Compare = std::less<Key>>
+    class flat_map : public detail::flat_tree<std::pair<Key, T>, Key, detail::key_first, Compare> {
+        using base = detail::flat_tree<std::pair<Key, T>, Key, detail::key_first, Compare>;
+
+    public:
+        using mapped_type = T;
+        using typename base::iterator;
+        using typename base::const_iterator;
+
+        using base::base;
+
+        /**
+         * @brief Inserts a value constructed from `args` unless `key` is already present.
+         * @return The position of the element with that key and whether the insertion took place.
+         */
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+            const auto position = this->lower_bound_of(this->values_, key);
+            if (position != this->values_.end() && !this->compare_(key, position->first))
+                return { position, false };
+            return { this->values_.emplace(position, std::piecewise_construct, std::forward_as_tuple(key),
+                                           std::forward_as_tuple(std::forward<Args>(args)...)), true };
+        }
+
+        T& operator[](const Key& key) {
+            return try_emplace(key).first->second;
+        }
+
+        /**
+         * @throws std::out_of_range If `key` is not present.
+         */
+        T& at(const Key& key) {
+            const auto position = this->find(key);
+            if (position == this->end())
+                throw std::out_of_range("flat_map::at: key not found");
+            return position->second;
+        }
+
+        const T& at(const Key& key) const {
+            const auto position = this->find(key);
+            if (position == this->end())
+                throw std::out_of_range("flat_map::at: key not found");
+            return position->second;
+        }
+    };
+    
+    // Memory - Arena and pool resources
+    //****************************************************************
+    /**
+     * @brief A bump-pointer memory resource whose blocks are kept and reused after every reset.
+     *
+     * Allocation advances a pointer inside the current block, deallocation does nothing, and `reset` rewinds the
+     * arena to its first block in O(1) per block. After the first few requests have warmed the arena up, a request
+     * which builds dozens of containers talks to the upstream resource not at all, and its teardown is one reset
+     * instead of thousands of frees.
+     *
+     * @details New blocks are obtained from the upstream resource, each one twice the size of the previous.
+     * An optional caller-provided buffer (e.g. on the stack) is used as the first block and never freed.
+     * The arena is not thread safe. Objects allocated from it must not be used after `reset` or `release`,
+     * and their destructors are not run by the arena.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::monotonic_arena arena;
+     * std::pmr::vector<int> vector(&arena);
+     * koncar::add_range(vector, 1, 2, 3);
+     * \endcode
+     */
+    class monotonic_arena : public std::pmr::memory_resource {
+    public:
+        explicit monotonic_arena(const std::size_t initial_block_size = 64 * 1024,
+                                 std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+            : upstream_(upstream), next_block_size_(std::max<std::size_t>(initial_block_size, 256)) {}
+
+        monotonic_arena(void* buffer, const std::size_t size, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+            : upstream_(upstream), next_block_size_(std::max<std::size_t>(size * 2, 256)) {
+            blocks_.push_back({ static_cast<std::byte*>(buffer), size, false });
+            cursor_ = blocks_.front().data;
+            limit_ = cursor_ + size;
+        }
+
+        monotonic_arena(const monotonic_arena&) = delete;
+        monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+        ~monotonic_arena() override {
+            release();
+        }
+
+        /**
+         * @brief Makes all memory of the arena available again, keeping every block for reuse.
+         */
+        void reset() noexcept {
+            current_ = 0;
+            used_ = 0;
+            cursor_ = blocks_.empty() ? nullptr : blocks_.front().data;
+            limit_ = blocks_.empty() ? nullptr : cursor_ + blocks_.front().size;
+        }
+
+        /**
+         * @brief Returns every block obtained from the upstream resource.
+         */
+        void release() noexcept {
+            std::erase_if(blocks_, [this](const block& b) {
+                if (b.owned)
+                    upstream_->deallocate(b.data, b.size, alignof(std::max_align_t));
+                return b.owned;
+            });
+            reset();
+        }
+
+        // Number of bytes handed out since the last reset, including alignment padding
+        std::size_t bytes_used() const noexcept { return used_; }
+
+        // Total size of all blocks currently held by the arena
+        std::size_t capacity() const noexcept {
+            std::size_t total = 0;
+            for (const block& b : blocks_)
+                total += b.size;
+            return total;
+        }
+
+        std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+    private:
+        struct block {
+            std::byte* data;
+            std::size_t size;
+            bool owned;
+        };
+
+        void* do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+            for (;;) {
+                if (cursor_) {
+                    const auto address = reinterpret_cast<std::uintptr_t>(cursor_);
+                    const std::size_t padding = (alignment - address % alignment) % alignment;
+                    if (padding + bytes <= static_cast<std::size_t>(limit_ - cursor_)) {
+                        std::byte* result = cursor_ + padding;
+                        cursor_ = result + bytes;
+                        used_ += padding + bytes;
+                        return result;
+                    }
+                }
+                next_block(bytes + alignment);
+            }
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        // Moves to the next kept block, or obtains a new one large enough for `minimum` bytes
+        void next_block(const std::size_t minimum) {
+            const std::size_t next = cursor_ ? current_ + 1 : 0;
+            if (next < blocks_.size()) {
+                current_ = next;
+            } else {
+                const std::size_t size = std::max(next_block_size_, minimum);
+                blocks_.push_back({ static_cast<std::byte*>(upstream_->allocate(size, alignof(std::max_align_t))), size, true });
+                next_block_size_ = size * 2;
+                current_ = blocks_.size() - 1;
+            }
+            cursor_ = blocks_[current_].data;
+            limit_ = cursor_ + blocks_[current_].size;
+        }
+
+        std::pmr::memory_resource* upstream_;
+        std::vector<block> blocks_;
+        std::size_t current_ = 0;
+        std::size_t next_block_size_;
+        std::size_t used_ = 0;
+        std::byte* cursor_ = nullptr;
+        std::byte* limit_ = nullptr;
+    };
+
+    /**
+     * @brief A memory resource which recycles freed blocks through per-size-class free lists.
+     *
+     * Requests up to `max_block_size` bytes are rounded up to a power-of-two size class (8, 16, ..., 4096 bytes)
+     * and served from slabs carved into equally sized blocks; deallocation pushes the block onto its class's
+     * free list in O(1). Larger requests go straight to the upstream resource.
+     *
+     * @details Layered on top of a koncar::monotonic_arena, the memory released by a growing std::pmr::vector is
+     * reused by later allocations of the same request instead of being wasted until the arena is reset.
+     * The pool is not thread safe, like std::pmr::unsynchronized_pool_resource.
+     */
+    class size_class_pool : public std::pmr::memory_resource {
+    public:
+        static constexpr std::size_t min_block_size = 8;
+        static constexpr std::size_t max_block_size = 4096;
+
+        explicit size_class_pool(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource(),
+                                 const std::size_t slab_size = 64 * 1024)
+            : upstream_(upstream), slab_size_(std::max(slab_size, max_block_size)) {}
+
+        size_class_pool(const size_class_pool&) = delete;
+        size_class_pool& operator=(const size_class_pool&) = delete;
+
+        ~size_class_pool() override {
+            release();
+        }
+
+        /**
+         * @brief Returns all slabs to the upstream resource. Every block handed out by the pool becomes invalid.
+         */
+        void release() noexcept {
+            for (const slab& s : slabs_)
+                upstream_->deallocate(s.data, slab_size_, s.alignment);
+            slabs_.clear();
+            free_lists_.fill(nullptr);
+        }
+
+        std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+    private:
+        static constexpr std::size_t class_count = std::countr_zero(max_block_size) - std::countr_zero(min_block_size) + 1;
+
+        struct free_node {
+            free_node* next;
+        };
+
+        struct slab {
+            void* data;
+            std::size_t alignment;
+        };
+
+        // Index of the smallest size class holding `bytes` with the given alignment, class_count if there is none
+        static std::size_t size_class(const std::size_t bytes, const std::size_t alignment) noexcept {
+            const std::size_t size = std::max({ bytes, alignment, min_block_size });
+            if (size > max_block_size)
+                return class_count;
+            return std::bit_width(size - 1) - std::countr_zero(min_block_size);
+        }
+
+        void* do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+            const std::size_t index = size_class(bytes, alignment);
+            if (index == class_count)
+                return upstream_->allocate(bytes, alignment);
+            if (!free_lists_[index])
+                refill(index);
+            free_node* node = free_lists_[index];
+            free_lists_[index] = node->next;
+            return node;
+        }
+
+        void do_deallocate(void* pointer, const std::size_t bytes, const std::size_t alignment) override {
+            const std::size_t index = size_class(bytes, alignment);
+            if (index == class_count) {
+                upstream_->deallocate(pointer, bytes, alignment);
+                return;
+            }
+            free_lists_[index] = ::new (pointer) free_node{ free_lists_[index] };
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        // Carves a new slab into blocks of size class `index` and puts them on its free list
+        void refill(const std::size_t index) {
+            const std::size_t block_size = min_block_size << index;
+            slabs_.reserve(slabs_.size() + 1);
+            auto* data = static_cast<std::byte*>(upstream_->allocate(slab_size_, block_size));
+            slabs_.push_back({ data, block_size });
+            for (std::size_t offset = slab_size_ - slab_size_ % block_size; offset != 0;) {
+                offset -= block_size;
+                free_lists_[index] = ::new (data + offset) free_node{ free_lists_[index] };
+            }
+        }
+
+        std::pmr::memory_resource* upstream_;
+        std::size_t slab_size_;
+        std::array<free_node*, class_count> free_lists_{};
+        std::vector<slab> slabs_;
+    };
+
+    /**
+     * @brief Creates a container which allocates from `resource` and fills it with koncar::add_range.
+     *
+     * The container must be constructible from a std::pmr::polymorphic_allocator (std::pmr::vector,
+     * std::pmr::string, std::pmr::unordered_map, ...). add_range constructs every element through the container's
+     * allocator, so allocator-aware elements (e.g. std::pmr::string inside std::pmr::vector) allocate from
+     * `resource` as well.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::monotonic_arena arena;
+     * auto names = koncar::make_container<std::pmr::vector<std::pmr::string>>(&arena, "alpha", "beta");
+     * // names and both of its strings live in the arena
+     * \endcode
+     */
+    template <typename Container, typename... Args>
+    Container make_container(std::pmr::memory_resource* resource, Args&&... args) {
+        Container container{ std::pmr::polymorphic_allocator<std::byte>(resource) };
+        if constexpr (sizeof...(Args) > 0)
+            add_range(container, std::forward<Args>(args)...);
+        return container;
+    }
+
+    template <typename Container, typename T>
+    Container make_container(std::pmr::memory_resource* resource, std::initializer_list<T> values) {
+        Container container{ std::pmr::polymorphic_allocator<std::byte>(resource) };
+        add_range(container, std::ranges::subrange(values.begin(), values.end()));
+        return container;
+    }
+
+    /**
+     * @brief Request-scoped memory: a size_class_pool on top of a monotonic_arena.
+     *
+     * Containers created with `make` allocate from the scope. Memory freed while the request runs is recycled
+     * by the pool; everything is discarded at once by `reset` (or the destructor), which keeps the arena's blocks
+     * for the next request.
+     *
+     * @details Containers created by the scope must be destroyed (or abandoned, for trivially destructible
+     * contents) before `reset` is called. The scope is meant to be owned by one request handler thread.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::request_scope scope;
+     * for (const auto& request : requests) {
+     *     {
+     *         auto ids = scope.make<std::pmr::vector<uint64_t>>(request.ids);
+     *         auto text = scope.make<std::pmr::string>();
+     *         // ... handle the request
+     *     }
+     *     scope.reset();
+     * }
+     * \endcode
+     */
+    class request_scope {
+    public:
+        explicit request_scope(const std::size_t initial_block_size = 64 * 1024,
+                               std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+            : arena_(initial_block_size, upstream), pool_(&arena_) {}
+
+        std::pmr::memory_resource* resource() noexcept { return &pool_; }
+        monotonic_arena& arena() noexcept { return arena_; }
+
+        template <typename Container, typename... Args>
+        Container make(Args&&... args) {
+            return make_container<Container>(resource(), std::forward<Args>(args)...);
+        }
+
+        template <typename Container, typename T>
+        Container make(std::initializer_list<T> values) {
+            return make_container<Container>(resource(), values);
+        }
+
+        /**
+         * @brief Discards all memory of the request at once.
+         */
+        void reset() noexcept {
+            pool_.release();
+            arena_.reset();
+        }
+
+    private:
+        monotonic_arena arena_;
+        size_class_pool pool_;
+    };
+    
+    // Diagnostics - Asynchronous error sink
+    //****************************************************************
+    /**
+     * @brief The kinds of errors koncar reports; each kind is rate limited separately.
+     */
+    enum class diagnostic_kind : std::uint8_t {
+        conversion_error,   // binary_to_string or string_to_binary failed
+        file_size_error,    // the size of a directory entry could not be read
+        entry_error,        // a directory entry could not be processed
+        directory_error,    // a directory could not be iterated
+    };
+
+    inline constexpr std::size_t diagnostic_kind_count = 4;
+
+    /**
+     * @brief A compact, trivially copyable error record, queued by the reporting thread and formatted by the writer thread.
+     *
+     * The path (if any) and the exception message share the fixed `text` buffer and are truncated to fit it.
+     */
+    struct diagnostic {
+        static constexpr std::size_t text_capacity = 232;
+
+        std::chrono::system_clock::time_point time;
+        // Records of this kind dropped by the rate limit or a full queue since the previous record of this kind
+        std::uint32_t suppressed = 0;
+        diagnostic_kind kind = diagnostic_kind::conversion_error;
+        std::uint16_t path_size = 0;
+        std::uint16_t message_size = 0;
+        char text[text_capacity];
+
+        std::string_view path() const noexcept { return { text, path_size }; }
+        std::string_view message() const noexcept { return { text + path_size, message_size }; }
+    };
+
+    /**
+     * @brief Appends the text line for `record` to `out`, in the format koncar used to write to std::cerr.
+     */
+    inline void format_diagnostic(std::string& out, const diagnostic& record) {
+        constexpr std::string_view prefixes[diagnostic_kind_count] = {
+            "Error: ", "Error getting file size: ", "Error processing entry: ", "Error iterating directory: "
+        };
+        out += prefixes[static_cast<std::size_t>(record.kind)];
+        if (record.path_size) {
+            out += '"';
+            out += record.path();
+            out += "\": ";
+        }
+        out += record.message();
+        if (record.suppressed) {
+            out += " (";
+            out += std::to_string(record.suppressed);
+            out += " similar errors suppressed)";
+        }
+        out += '\n';
+    }
+
+    /**
+     * @brief Destination of diagnostic records. Implementations are called on the writer thread only.
+     */
+    class diagnostic_sink {
+    public:
+        virtual ~diagnostic_sink() = default;
+
+        // Receives the records in the order they were queued, in batches as large as the queue allows
+        virtual void write(std::span<const diagnostic> records) = 0;
+    };
+
+    // Formats every batch into one string and writes it to a stream with a single write and flush
+    class ostream_sink final : public diagnostic_sink {
+    public:
+        explicit ostream_sink(std::ostream& stream) : stream_(stream) {}
+
+        void write(const std::span<const diagnostic> records) override {
+            text_.clear();
+            for (const auto& record : records)
+                format_diagnostic(text_, record);
+            stream_.write(text_.data(), static_cast<std::streamsize>(text_.size()));
+            stream_.flush();
+        }
+
+    private:
+        std::ostream& stream_;
+        std::string text_;
+    };
+
+    // Hands every record to a callable, e.g. to route diagnostics into an application logger
+    class function_sink final : public diagnostic_sink {
+    public:
+        explicit function_sink(std::function<void(const diagnostic&)> function) : function_(std::move(function)) {}
+
+        void write(const std::span<const diagnostic> records) override {
+            for (const auto& record : records)
+                function_(record);
+        }
+
+    private:
+        std::function<void(const diagnostic&)> function_;
+    };
+
+    // Drops every record
+    class null_sink final : public diagnostic_sink {
+    public:
+        void write(std::span<const diagnostic>) override {}
+    };
+
+    /**
+     * @brief Options for constructing koncar::diagnostics.
+     *
+     * @param queue_capacity Number of records the queue holds; records reported while it is full are dropped and counted.
+     * @param burst Records of one kind accepted per window; further records of that kind are dropped and counted.
+     * @param window Length of the rate-limiting window.
+     */
+    struct diagnostics_options {
+        std::size_t queue_capacity = 1024;
+        std::uint32_t burst = 32;
+        std::chrono::milliseconds window{ 1000 };
+    };
+
+    /**
+     * @brief Asynchronous diagnostics: reporting threads queue binary records, a background thread formats and writes them.
+     *
+     * `report` never blocks and never allocates: it applies the per-kind rate limit, copies the path and message
+     * into a fixed-size record and pushes it onto a lock-free multi-producer ring buffer, whose producers never wait
+     * for one another. The writer thread sleeps until records arrive and passes them to the sink in batches. Dropped records are counted and the count is
+     * attached to the next accepted record of the same kind.
+     *
+     * @details koncar's own functions report through koncar::default_diagnostics(), whose sink writes one line per record
+     * to std::cerr. Replace the sink with `set_sink` to route diagnostics elsewhere, or with koncar::null_sink to drop them.
+     * `flush` waits until every record accepted so far has been written. The destructor writes the remaining records
+     * and joins the writer thread, so records are never lost on a normal exit; `flush` is only needed to order
+     * diagnostics before other output.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::default_diagnostics().set_sink(std::make_shared<koncar::function_sink>([](const koncar::diagnostic& record) {
+     *     app_log.error("koncar: {} {}", record.path(), record.message());
+     * }));
+     * \endcode
+     */
+    class diagnostics {
+    public:
+        explicit diagnostics(std::shared_ptr<diagnostic_sink> sink = std::make_shared<ostream_sink>(std::cerr), const diagnostics_options& options = {})
+            : queue_(options.queue_capacity), sink_(std::move(sink)), burst_(options.burst),
+              window_(std::chrono::duration_cast<std::chrono::nanoseconds>(options.window).count()) {
+            writer_ = std::thread([this] { write_loop(); });
+        }
+
+        diagnostics(const diagnostics&) = delete;
+        diagnostics& operator=(const diagnostics&) = delete;
+
+        ~diagnostics() {
+            stopping_.store(true, std::memory_order_release);
+            wake_writer();
+            writer_.join();
+        }
+
+        /**
+         * @brief Queues one record unless its kind is over the rate limit or the queue is full. Never blocks.
+         */
+        void report(const diagnostic_kind kind, const std::string_view path, const std::string_view message) noexcept {
+            limiter& limit = limiters_[static_cast<std::size_t>(kind)];
+            if (!admit(limit)) {
+                limit.suppressed.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            diagnostic record;
+            record.time = std::chrono::system_clock::now();
+            record.kind = kind;
+            record.suppressed = limit.suppressed.exchange(0, std::memory_order_relaxed);
+            record.path_size = static_cast<std::uint16_t>(std::min(path.size(), diagnostic::text_capacity));
+            record.message_size = static_cast<std::uint16_t>(std::min(message.size(), diagnostic::text_capacity - record.path_size));
+            if (record.path_size)
+                std::memcpy(record.text, path.data(), record.path_size);
+            if (record.message_size)
+                std::memcpy(record.text + record.path_size, message.data(), record.message_size);
+
+            if (!queue_.try_push(record)) {
+                limit.suppressed.fetch_add(record.suppressed + 1, std::memory_order_relaxed);
+                return;
+            }
+            accepted_.fetch_add(1, std::memory_order_release);
+            wake_writer();
+        }
+
+        /**
+         * @brief Replaces the sink; records already queued go to the new sink.
+         */
+        void set_sink(std::shared_ptr<diagnostic_sink> sink) {
+            std::lock_guard lock(sink_mutex_);
+            sink_ = std::move(sink);
+        }
+
+        /**
+         * @brief Waits until every record accepted so far has been passed to the sink.
+         */
+        void flush() {
+            const std::uint64_t target = accepted_.load(std::memory_order_acquire);
+            for (std::uint64_t written = written_.load(std::memory_order_acquire); written < target; written = written_.load(std::memory_order_acquire))
+                written_.wait(written, std::memory_order_acquire);
+        }
+
+    private:
+        struct alignas(64) limiter {
+            std::atomic<std::int64_t> window_start{ std::numeric_limits<std::int64_t>::min() / 2 };
+            std::atomic<std::uint32_t> count{ 0 };
+            std::atomic<std::uint32_t> suppressed{ 0 };
+        };
+
+        // Fixed-window rate limit; the window restarts with the first record after it has expired
+        bool admit(limiter& limit) noexcept {
+            const std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            std::int64_t start = limit.window_start.load(std::memory_order_relaxed);
+            if (now - start >= window_ && limit.window_start.compare_exchange_strong(start, now, std::memory_order_relaxed))
+                limit.count.store(0, std::memory_order_relaxed);
+            return limit.count.fetch_add(1, std::memory_order_relaxed) < burst_;
+        }
+
+        void wake_writer() noexcept {
+            signal_.fetch_add(1, std::memory_order_release);
+            signal_.notify_one();
+        }
+
+        void write_loop() {
+            for (;;) {
+                const std::uint32_t seen = signal_.load(std::memory_order_acquire);
+                for (std::span<diagnostic> batch = queue_.peek_batch(); !batch.empty(); batch = queue_.peek_batch()) {
+                    {
+                        std::lock_guard lock(sink_mutex_);
+                        try {
+                            if (sink_)
+                                sink_->write(batch);
+                        } catch (...) {
+                            // A failing sink loses this batch but must not stop the writer
+                        }
+                    }
+                    queue_.release(batch.size());
+                    written_.fetch_add(batch.size(), std::memory_order_release);
+                    written_.notify_all();
+                }
+                if (stopping_.load(std::memory_order_acquire) && queue_.empty())
+                    return;
+                signal_.wait(seen, std::memory_order_acquire);
+            }
+        }
+
+        mpsc_ring_buffer<diagnostic> queue_;
+        std::array<limiter, diagnostic_kind_count> limiters_;
+        std::mutex sink_mutex_;
+        std::shared_ptr<diagnostic_sink> sink_;
+        const std::uint32_t burst_;
+        const std::int64_t window_;
+        alignas(64) std::atomic<std::uint64_t> accepted_{ 0 };
+        alignas(64) std::atomic<std::uint64_t> written_{ 0 };
+        std::atomic<std::uint32_t> signal_{ 0 };
+        std::atomic<bool> stopping_{ false };
+        std::thread writer_;
+    };
+
+    /**
+     * @brief Returns the diagnostics instance koncar's functions report to, created on first use.
+     *
+     * Its sink writes to std::cerr until it is replaced with `set_sink`. The first call, usually the first error
+     * koncar reports, starts the writer thread. The instance is a function-local static, so it drains the queue
+     * and joins the thread when the process returns from main or calls std::exit.
+     */
+    inline diagnostics& default_diagnostics() {
+        static diagnostics instance;
+        return instance;
+    }
+
+    namespace detail {
+
+        // Reports an error to koncar::default_diagnostics(); the error is dropped if the diagnostics cannot be started
+        inline void report_diagnostic(const diagnostic_kind kind, const std::string_view path, const std::string_view message) noexcept {
+            try {
+                default_diagnostics().report(kind, path, message);
+            } catch (...) {
+            }
+        }
+
+    }
+    
+    // Strings - Hexadecimal kernels
+    //****************************************************************
+    /**
+     * @brief One implementation of the hexadecimal encoder and decoder used by koncar's conversion functions.
+     *
+     * `encode` writes `2 * size` characters for `size` bytes and returns the end of the output. `decode` converts
+     * `size` characters (an even number) into `size / 2` bytes and returns nullptr, or a pointer to the first
+     * character which is not a hexadecimal digit; bytes before the block containing that character are written.
+     */
+    struct hex_kernel {
+        using encode_function = char* (*)(const std::uint8_t* data, std::size_t size, char* out, bool uppercase) noexcept;
+        using decode_function = const char* (*)(const char* text, std::size_t size, std::uint8_t* out) noexcept;
+
+        std::string_view name;
+        encode_function encode;
+        decode_function decode;
+    };
+
+    namespace detail {
+
+        inline constexpr std::string_view hex_digits[2] = { "0123456789abcdef", "0123456789ABCDEF" };
+
+        // Value of every character as a hexadecimal digit, 0xFF for characters which are not digits
+        inline constexpr auto hex_values = [] {
+            std::array<std::uint8_t, 256> values{};
+            for (auto& value : values)
+                value = 0xFF;
+            for (int c = 0; c < 10; ++c)
+                values['0' + c] = static_cast<std::uint8_t>(c);
+            for (int c = 0; c < 6; ++c)
+                values['a' + c] = values['A' + c] = static_cast<std::uint8_t>(10 + c);
+            return values;
+        }();
+
+        inline char* encode_hex_scalar(const std::uint8_t* data, const std::size_t size, char* out, const bool uppercase) noexcept {
+            const char* digits = hex_digits[uppercase].data();
+            for (std::size_t i = 0; i < size; ++i) {
+                *out++ = digits[data[i] >> 4];
+                *out++ = digits[data[i] & 0x0F];
+            }
+            return out;
+        }
+
+        inline const char* decode_hex_scalar(const char* text, const std::size_t size, std::uint8_t* out) noexcept {
+            for (std::size_t i = 0; i < size; i += 2) {
+                const std::uint8_t high = hex_values[static_cast<unsigned char>(text[i])];
+                const std::uint8_t low = hex_values[static_cast<unsigned char>(text[i + 1])];
+                if ((high | low) & 0xF0)
+                    return high & 0xF0 ? text + i : text + i + 1;
+                *out++ = static_cast<std::uint8_t>(high << 4 | low);
+            }
+            return nullptr;
+        }
+
+#ifdef KONCAR_X86_KERNELS
+        // The x86 kernels share one scheme. Encoding splits every byte into nibbles, looks both up in a 16-entry
+        // digit table with a byte shuffle and interleaves them. Decoding maps '0'-'9' and 'a'-'f'/'A'-'F' to their
+        // values, rejects a block containing any other character (the scalar kernel then locates it), and combines
+        // each pair of nibbles with a multiply-add by { 16, 1 }. Tails shorter than a block go through the scalar kernel.
+
+        __attribute__((target("ssse3")))
+        inline char* encode_hex_ssse3(const std::uint8_t* data, const std::size_t size, char* out, const bool uppercase) noexcept {
+            const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex_digits[uppercase].data()));
+            const __m128i nibble = _mm_set1_epi8(0x0F);
+            std::size_t i = 0;
+            for (; i + 16 <= size; i += 16, out += 32) {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+                const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, nibble));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(high, low));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(high, low));
+            }
+            return encode_hex_scalar(data + i, size - i, out, uppercase);
+        }
+
+        __attribute__((target("ssse3")))
+        inline bool decode_hex_block_ssse3(const __m128i text, __m128i& values) noexcept {
+            const __m128i digit = _mm_sub_epi8(text, _mm_set1_epi8('0'));
+            const __m128i letter = _mm_sub_epi8(_mm_or_si128(text, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+            const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+            const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+            values = _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+            return _mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) == 0xFFFF;
+        }
+
+        __attribute__((target("ssse3")))
+        inline const char* decode_hex_ssse3(const char* text, const std::size_t size, std::uint8_t* out) noexcept {
+            const __m128i weights = _mm_set1_epi16(0x0110);
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32, out += 16) {
+                __m128i first, second;
+                if (!decode_hex_block_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i)), first)
+                    || !decode_hex_block_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + 16)), second))
+                    break;
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                                 _mm_packus_epi16(_mm_maddubs_epi16(first, weights), _mm_maddubs_epi16(second, weights)));
+            }
+            return decode_hex_scalar(text + i, size - i, out);
+        }
+
+        __attribute__((target("avx2")))
+        inline char* encode_hex_avx2(const std::uint8_t* data, const std::size_t size, char* out, const bool uppercase) noexcept {
+            const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex_digits[uppercase].data())));
+            const __m256i nibble = _mm256_set1_epi8(0x0F);
+            std::size_t i = 0;
+            for (; i + 32 <= size; i += 32, out += 64) {
+                const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                const __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble));
+                const __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, nibble));
+                // Interleaving works within 128-bit lanes, so the halves are put back in order afterwards
+                const __m256i first = _mm256_unpacklo_epi8(high, low);
+                const __m256i second = _mm256_unpackhi_epi8(high, low);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(first, second, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), _mm256_permute2x128_si256(first, second, 0x31));
+            }
+            return encode_hex_ssse3(data + i, size - i, out, uppercase);
+        }
+
+        __attribute__((target("avx2")))
+        inline bool decode_hex_block_avx2(const __m256i text, __m256i& values) noexcept {
+            const __m256i digit = _mm256_sub_epi8(text, _mm256_set1_epi8('0'));
+            const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(text, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+            const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+            const __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+            values = _mm256_blendv_epi8(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), digit, is_digit);
+            return _mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)) == -1;
+        }
+
+        __attribute__((target("avx2")))
+        inline const char* decode_hex_avx2(const char* text, const std::size_t size, std::uint8_t* out) noexcept {
+            const __m256i weights = _mm256_set1_epi16(0x0110);
+            std::size_t i = 0;
+            for (; i + 64 <= size; i += 64, out += 32) {
+                __m256i first, second;
+                if (!decode_hex_block_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i)), first)
+                    || !decode_hex_block_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + 32)), second))
+                    break;
+                // Packing works within 128-bit lanes, so the 64-bit quarters are put back in order afterwards
+                const __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights), _mm256_maddubs_epi16(second, weights));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+            }
+            return decode_hex_ssse3(text + i, size - i, out);
+        }
+
+        __attribute__((target("avx512bw")))
+        inline char* encode_hex_avx512(const std::uint8_t* data, const std::size_t size, char* out, const bool uppercase) noexcept {
+            // The zero-masking forms avoid GCC's -Wuninitialized false positive on the unmasked intrinsics
+            const __m512i digits = _mm512_maskz_broadcast_i32x4(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex_digits[uppercase].data())));
+            const __m512i nibble = _mm512_set1_epi8(0x0F);
+            const __m512i first_order = _mm512_setr_epi64(0, 1, 8, 9, 2, 3, 10, 11);
+            const __m512i second_order = _mm512_setr_epi64(4, 5, 12, 13, 6, 7, 14, 15);
+            std::size_t i = 0;
+            for (; i + 64 <= size; i += 64, out += 128) {
+                const __m512i bytes = _mm512_loadu_si512(data + i);
+                const __m512i high = _mm512_shuffle_epi8(digits, _mm512_and_si512(_mm512_srli_epi16(bytes, 4), nibble));
+                const __m512i low = _mm512_shuffle_epi8(digits, _mm512_and_si512(bytes, nibble));
+                const __m512i first = _mm512_unpacklo_epi8(high, low);
+                const __m512i second = _mm512_unpackhi_epi8(high, low);
+                _mm512_storeu_si512(out, _mm512_permutex2var_epi64(first, first_order, second));
+                _mm512_storeu_si512(out + 64, _mm512_permutex2var_epi64(first, second_order, second));
+            }
+            return encode_hex_avx2(data + i, size - i, out, uppercase);
+        }
+
+        __attribute__((target("avx512bw")))
+        inline bool decode_hex_block_avx512(const __m512i text, __m512i& values) noexcept {
+            const __m512i digit = _mm512_sub_epi8(text, _mm512_set1_epi8('0'));
+            const __m512i letter = _mm512_sub_epi8(_mm512_or_si512(text, _mm512_set1_epi8(0x20)), _mm512_set1_epi8('a'));
+            const __mmask64 is_digit = _mm512_cmple_epu8_mask(digit, _mm512_set1_epi8(9));
+            const __mmask64 is_letter = _mm512_cmple_epu8_mask(letter, _mm512_set1_epi8(5));
+            values = _mm512_mask_blend_epi8(is_digit, _mm512_add_epi8(letter, _mm512_set1_epi8(10)), digit);
+            return (is_digit | is_letter) == ~__mmask64{ 0 };
+        }
+
+        __attribute__((target("avx512bw")))
+        inline const char* decode_hex_avx512(const char* text, const std::size_t size, std::uint8_t* out) noexcept {
+            const __m512i weights = _mm512_set1_epi16(0x0110);
+            const __m512i order = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+            std::size_t i = 0;
+            for (; i + 128 <= size; i += 128, out += 64) {
+                __m512i first, second;
+                if (!decode_hex_block_avx512(_mm512_loadu_si512(text + i), first)
+                    || !decode_hex_block_avx512(_mm512_loadu_si512(text + i + 64), second))
+                    break;
+                const __m512i packed = _mm512_packus_epi16(_mm512_maddubs_epi16(first, weights), _mm512_maddubs_epi16(second, weights));
+                _mm512_storeu_si512(out, _mm512_maskz_permutexvar_epi64(0xFF, order, packed));
+            }
+            return decode_hex_avx2(text + i, size - i, out);
+        }
+#endif
+
+        // Kernels supported by this CPU, fastest first; the scalar kernel is always last
+        inline std::span<const hex_kernel> supported_hex_kernels() noexcept {
+            struct kernel_list {
+                std::array<hex_kernel, 4> kernels;
+                std::size_t count = 0;
+            };
+            static const kernel_list list = [] {
+                kernel_list result;
+#ifdef KONCAR_X86_KERNELS
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512bw"))
+                    result.kernels[result.count++] = { "avx512bw", encode_hex_avx512, decode_hex_avx512 };
+                if (__builtin_cpu_supports("avx2"))
+                    result.kernels[result.count++] = { "avx2", encode_hex_avx2, decode_hex_avx2 };
+                if (__builtin_cpu_supports("ssse3"))
+                    result.kernels[result.count++] = { "ssse3", encode_hex_ssse3, decode_hex_ssse3 };
+#endif
+                result.kernels[result.count++] = { "scalar", encode_hex_scalar, decode_hex_scalar };
+                return result;
+            }();
+            return { list.kernels.data(), list.count };
+        }
+
+        inline std::atomic<const hex_kernel*>& active_hex_kernel_slot() noexcept {
+            static std::atomic<const hex_kernel*> slot{ supported_hex_kernels().data() };
+            return slot;
+        }
+
+    }
+
+    /**
+     * @brief Returns the hexadecimal kernels this CPU supports, fastest first. The last one is always "scalar".
+     */
+    inline std::span<const hex_kernel> hex_kernels() noexcept {
+        return detail::supported_hex_kernels();
+    }
+
+    /**
+     * @brief Returns the hexadecimal kernel koncar's conversion functions currently use.
+     *
+     * @details The kernel is chosen on first use from the instruction sets the CPU reports (AVX-512BW, AVX2, SSSE3 on x86
+     * with GCC or Clang) and can be replaced with koncar::select_hex_kernel. Every kernel produces the same output.
+     */
+    inline const hex_kernel& active_hex_kernel() noexcept {
+        return *detail::active_hex_kernel_slot().load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Makes koncar's conversion functions use the supported kernel called `name`.
+     * @return false if this CPU does not support a kernel of that name; the active kernel is unchanged then.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::select_hex_kernel("scalar"); // e.g. to compare against the vectorized kernels
+     * \endcode
+     */
+    inline bool select_hex_kernel(const std::string_view name) noexcept {
+        for (const hex_kernel& kernel : hex_kernels()) {
+            if (kernel.name == name) {
+                detail::active_hex_kernel_slot().store(&kernel, std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    namespace detail {
+
+        /**
+         * @brief Encodes `size` bytes as hexadecimal into `out`, which must have room for `2 * size` characters.
+         * @return Pointer one past the last character written.
+         */
+        inline char* encode_hex(const std::uint8_t* data, const std::size_t size, char* out, const bool uppercase) noexcept {
+            // Short inputs do not reach a vector block, so they skip the dispatch
+            if (size < 16)
+                return encode_hex_scalar(data, size, out, uppercase);
+            return active_hex_kernel().encode(data, size, out, uppercase);
+        }
+
+        /**
+         * @brief Decodes `size` hexadecimal characters (an even number) into `out`, which must have room for `size / 2` bytes.
+         * @return nullptr on success, otherwise a pointer to the first character which is not a hexadecimal digit.
+         */
+        inline const char* decode_hex(const char* text, const std::size_t size, std::uint8_t* out) noexcept {
+            if (size < 32)
+                return decode_hex_scalar(text, size, out);
+            return active_hex_kernel().decode(text, size, out);
+        }
+
+    }
+
+    // Task 2.1
+    //****************************************************************
+    /**
+     * @brief Converts binary data to a hexadecimal string representation.
+     *
+     * This function takes a vector of binary data and converts it into a hexadecimal string representation.
+     * Each byte in the input vector is converted to its hexadecimal representation and concatenated to form the output string.
+     * If an error occurs during the conversion process, an exception of type std::exception is thrown.
+     * The function handles the exception and returns an empty string to indicate failure.
+     *
+     * @param data The vector of binary data to be converted to a hexadecimal string.
+     * @param uppercase Optional flag indicating whether the resulting hexadecimal string should be in uppercase (default is true).
+     * @return A hexadecimal string representation of the input binary data, or an empty string if conversion fails.
+     *
+     * @details This function sizes the output string once and encodes the bytes with koncar::active_hex_kernel(),
+     * the fastest kernel the CPU supports. The resulting string contains the hexadecimal representation of the binary data.
+     * Optionally, the function allows specifying whether the hexadecimal characters should be in uppercase.
+     * Any errors encountered during the conversion process are caught and handled.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const std::vector<uint8_t> binary_data = { 0xBA, 0xAD, 0xF0, 0x0D };
+     * const std::string hex_string = koncar::binary_to_string(binary_data);
+     * // hex_string contains "BAADF00D"
+     * \endcode
+     */
+    inline std::string binary_to_string(const std::vector<uint8_t>& data, const bool uppercase = true) {
+        try {
+            std::string result(data.size() * 2, '\0');
+            detail::encode_hex(data.data(), data.size(), result.data(), uppercase);
+            return result;
+        } catch (const std::exception& e) {
+            // Handle the exception
+            detail::report_diagnostic(diagnostic_kind::conversion_error, {}, e.what());
+            // Return an empty string to indicate failure
+            return "";
+        }
+    }
+    
+    // Task 2.2
+    //****************************************************************
+    /**
+     * @brief Converts a hexadecimal string to binary data.
+     *
+     * This function takes a hexadecimal string and converts it into a vector of binary data.
+     * Each pair of hexadecimal characters in the input string represents one byte of binary data,
+     * which is then appended to the output vector.
+     * If the input string contains invalid hexadecimal characters or results in bytes outside the range [0, 255],
+     * or if the input string does not contain an even number of characters, exception of type std::invalid_argument if thrown. 
+     * Any exceptions thrown during the conversion process are caught locally, and an empty vector is returned
+     * to indicate failure.
+     *
+     * @param str The hexadecimal string to be converted to binary data.
+     * @return A vector of binary data representing the input hexadecimal string, or an empty vector if conversion fails.
+     *
+     * @details This function converts pairs of hexadecimal characters into their corresponding binary representation
+     * with koncar::active_hex_kernel(), writing the bytes into an output vector sized once.
+     * It checks for the even length of the input string and ensures that each character in the substring
+     * contains valid hexadecimal characters. Any invalid characters or odd-length input strings result in an exception,
+     * which is caught and handled.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const std::string hex_string = "BAADF00D";
+     * std::vector<uint8_t> binary_data = koncar::string_to_binary(hex_string);
+     * // binary_data contains { 0xBA, 0xAD, 0xF0, 0x0D }
+     * \endcode
+     */
+    inline std::vector<uint8_t> string_to_binary(const std::string& str) {
+        try {
+            // Check if the input string has an even length
+            if (str.size() & 1) {
+                throw std::invalid_argument("Input string length must be even");
+            }
+        
+            std::vector<uint8_t> result(str.size() / 2);
+            // Check that every character is a valid hexadecimal digit while converting
+            if (const char* invalid = detail::decode_hex(str.data(), str.size(), result.data())) {
+                throw std::invalid_argument("Invalid hexadecimal character: " + std::string(1, *invalid));
+            }
+            return result;
+        } catch (const std::exception& e) {
+            // Handle the exception
+            detail::report_diagnostic(diagnostic_kind::conversion_error, {}, e.what());
+            // Return an empty vector to indicate failure
+            return {};
+        }
+    }
+
+    // Strings - Pre-sized concatenation
+    //****************************************************************
+    /**
+     * @brief Non-owning view of binary data which is rendered as hexadecimal text.
+     *
+     * Used as a koncar::str_append piece: the bytes are encoded straight into the destination string,
+     * without the temporary std::string produced by binary_to_string. Written to a std::ostream, the text is
+     * likewise encoded block by block into the stream buffer.
+     */
+    struct hex_view {
+        std::span<const std::uint8_t> bytes;
+        bool uppercase = true;
+
+        hex_view(const std::span<const std::uint8_t> data, const bool upper = true) noexcept : bytes(data), uppercase(upper) {}
+
+        // Number of characters of the hexadecimal representation
+        std::size_t size() const noexcept { return bytes.size() * 2; }
+    };
+
+    namespace detail {
+
+        // Integer pieces are written in decimal; bool and character types are handled separately
+        template <typename T>
+        concept integer_piece = std::integral<T> && !std::same_as<T, bool> && !std::same_as<T, char>
+            && !std::same_as<T, wchar_t> && !std::same_as<T, char8_t> && !std::same_as<T, char16_t> && !std::same_as<T, char32_t>;
+
+        template <typename T>
+        concept string_piece = std::convertible_to<const T&, std::string_view> && !std::same_as<T, hex_view>;
+
+        // Number of decimal digits of `value`
+        constexpr std::size_t decimal_digits(unsigned long long value) noexcept {
+            std::size_t digits = 1;
+            for (; value >= 10000; value /= 10000)
+                digits += 4;
+            return digits + (value >= 10) + (value >= 100) + (value >= 1000);
+        }
+
+        // Magnitude of an integer as unsigned long long, well defined for the minimum value of signed types
+        template <integer_piece T>
+        constexpr unsigned long long magnitude(const T value) noexcept {
+            if constexpr (std::is_signed_v<T>)
+                return value < 0 ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+            else
+                return value;
+        }
+
+        // Exact number of characters `piece` occupies in the output
+        template <typename Piece>
+        constexpr std::size_t piece_length(const Piece& piece) noexcept {
+            if constexpr (std::same_as<Piece, char>)
+                return 1;
+            else if constexpr (std::same_as<Piece, bool>)
+                return piece ? 4 : 5;
+            else if constexpr (integer_piece<Piece>)
+                return decimal_digits(magnitude(piece)) + (piece < Piece{});
+            else if constexpr (std::same_as<Piece, hex_view>)
+                return piece.size();
+            else
+                return std::string_view(piece).size();
+        }
+
+        // Writes `piece` at `out`, which has exactly piece_length(piece) characters of room, and returns the end
+        template <typename Piece>
+        char* write_piece(char* out, const Piece& piece) noexcept {
+            if constexpr (std::same_as<Piece, char>) {
+                *out = piece;
+                return out + 1;
+            } else if constexpr (std::same_as<Piece, bool>) {
+                const std::string_view text = piece ? "true" : "false";
+                return std::copy(text.begin(), text.end(), out);
+            } else if constexpr (integer_piece<Piece>) {
+                return std::to_chars(out, out + piece_length(piece), piece).ptr;
+            } else if constexpr (std::same_as<Piece, hex_view>) {
+                return encode_hex(piece.bytes.data(), piece.bytes.size(), out, piece.uppercase);
+            } else {
+                const std::string_view text(piece);
+                if (!text.empty())
+                    std::memcpy(out, text.data(), text.size());
+                return out + text.size();
+            }
+        }
+
+        template <typename Piece>
+        concept str_piece = std::same_as<Piece, char> || std::same_as<Piece, bool> || integer_piece<Piece>
+            || std::same_as<Piece, hex_view> || string_piece<Piece>;
+
+    }
+
+    /**
+     * @brief Appends several pieces to a string with a single allocation.
+     *
+     * This function computes the exact length of all pieces first, grows the string once and then writes every
+     * piece directly into the string's buffer. Integers are formatted with std::to_chars and binary data wrapped in
+     * koncar::hex_view is hex-encoded in place, so no intermediate strings are created.
+     *
+     * @tparam Pieces The types of the pieces: `char`, `bool`, integer types, koncar::hex_view,
+     * and anything convertible to std::string_view (std::string, string literals, ...).
+     * @param out The string to which the pieces will be appended.
+     * @param pieces The pieces to be appended, in order.
+     * @return Reference to `out`.
+     *
+     * @details Lengths of characters and booleans are known at compile time, lengths of the other pieces are
+     * computed in a first pass which touches no memory of the destination. When the standard library offers
+     * `resize_and_overwrite` (C++23), the new characters are not zero-filled before being written.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const std::vector<uint8_t> frame = { 0xBA, 0xAD, 0xF0, 0x0D };
+     * std::string message = "frame ";
+     * koncar::str_append(message, 42, " of ", frame.size(), " bytes: ", koncar::hex_view(frame));
+     * // message contains "frame 42 of 4 bytes: BAADF00D"
+     * \endcode
+     */
+    template <typename... Pieces>
+        requires (detail::str_piece<std::decay_t<Pieces>> && ...)
+    std::string& str_append(std::string& out, const Pieces&... pieces) {
+        const std::size_t old_size = out.size();
+        const std::size_t new_size = old_size + (detail::piece_length(pieces) + ... + 0);
+        const auto write = [&](char* buffer) {
+            char* cursor = buffer + old_size;
+            ((cursor = detail::write_piece(cursor, pieces)), ...);
+            return new_size;
+        };
+#ifdef __cpp_lib_string_resize_and_overwrite
+        out.resize_and_overwrite(new_size, [&](char* buffer, std::size_t) { return write(buffer); });
+#else
+        out.resize(new_size);
+        write(out.data());
+#endif
+        return out;
+    }
+
+    /**
+     * @brief Concatenates several pieces into a new string with a single allocation, see str_append.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const std::string text = koncar::str_concat("error ", -5, ": ", "timeout");
+     * // text contains "error -5: timeout"
+     * \endcode
+     */
+    template <typename... Pieces>
+        requires (detail::str_piece<std::decay_t<Pieces>> && ...)
+    std::string str_concat(const Pieces&... pieces) {
+        std::string result;
+        str_append(result, pieces...);
+        return result;
+    }
+
+    namespace detail {
+
+        // Fill, alignment and width of a hex_view written to a stream
+        struct hex_format_spec {
+            char fill = ' ';
+            char align = '<';       // '<', '>' or '^'
+            std::size_t width = 0;
+        };
+
+        /**
+         * @brief Writes the padded hexadecimal text of `view` through `write(const char*, std::size_t)`, in blocks
+         * encoded on the stack, so that no string of the whole text is ever allocated.
+         */
+        template <typename Write>
+        void write_hex(const hex_view& view, const hex_format_spec& spec, Write&& write) {
+            char block[4096];
+            const std::size_t padding = spec.width > view.size() ? spec.width - view.size() : 0;
+            const std::size_t before = spec.align == '>' ? padding : spec.align == '^' ? padding / 2 : 0;
+
+            const auto pad = [&](std::size_t count) {
+                if (!count)
+                    return;
+                std::memset(block, spec.fill, std::min(count, sizeof block));
+                for (std::size_t piece; count; count -= piece) {
+                    piece = std::min(count, sizeof block);
+                    write(static_cast<const char*>(block), piece);
+                }
+            };
+
+            pad(before);
+            for (std::size_t offset = 0; offset < view.bytes.size(); offset += sizeof block / 2) {
+                const std::size_t count = std::min(view.bytes.size() - offset, sizeof block / 2);
+                encode_hex(view.bytes.data() + offset, count, block, view.uppercase);
+                write(static_cast<const char*>(block), 2 * count);
+            }
+            pad(padding - before);
+        }
+
+    }
+
+    /**
+     * @brief Writes binary data to a stream as hexadecimal text, encoding it block by block into the stream buffer.
+     *
+     * The stream's width, fill and adjustment apply to the whole text (right-aligned unless std::left is set)
+     * and the width is reset, as for strings. The case is the one of the view.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * std::cout << "payload " << koncar::hex_view(buffer, false) << '\n';
+     * \endcode
+     */
+    inline std::ostream& operator<<(std::ostream& os, const hex_view& view) {
+        const std::ostream::sentry sentry(os);
+        if (!sentry)
+            return os;
+
+        detail::hex_format_spec spec;
+        spec.fill = os.fill();
+        spec.align = (os.flags() & std::ios_base::adjustfield) == std::ios_base::left ? '<' : '>';
+        spec.width = os.width() > 0 ? static_cast<std::size_t>(os.width()) : 0;
+        os.width(0);
+
+        bool failed = false;
+        try {
+            std::streambuf& buffer = *os.rdbuf();
+            detail::write_hex(view, spec, [&](const char* text, const std::size_t size) {
+                if (!failed && buffer.sputn(text, static_cast<std::streamsize>(size)) != static_cast<std::streamsize>(size))
+                    failed = true;
+            });
+        } catch (...) {
+            failed = true;
+        }
+        if (failed)
+            os.setstate(std::ios_base::badbit);
+        return os;
+    }
+
+    // Strings - Checksummed hexadecimal
+    //****************************************************************
+    /**
+     * @brief Checksums which koncar::binary_to_string and koncar::string_to_binary can append and verify.
+     *
+     * crc32c is CRC-32C (Castagnoli), written as 8 hexadecimal digits; xxhash64 is XXH64 with seed 0, written
+     * as 16 digits. Digits follow the value from the most significant one, as the checksum is usually printed.
+     */
+    enum class checksum : uint8_t {
+        crc32c,
+        xxhash64
+    };
+
+    // Number of hexadecimal digits the checksum adds to the text
+    inline constexpr std::size_t checksum_digits(const checksum kind) noexcept {
+        return kind == checksum::crc32c ? 8 : 16;
+    }
+
+    namespace detail {
+
+        // Reflected CRC-32C polynomial
+        inline constexpr uint32_t crc32c_polynomial = 0x82F63B78;
+
+        // Slicing-by-8 tables: table[k][b] is the CRC of byte b followed by k zero bytes
+        inline constexpr auto crc32c_table = [] {
+            std::array<std::array<uint32_t, 256>, 8> table{};
+            for (uint32_t byte = 0; byte < 256; ++byte) {
+                uint32_t crc = byte;
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = crc & 1 ? (crc >> 1) ^ crc32c_polynomial : crc >> 1;
+                table[0][byte] = crc;
+            }
+            for (std::size_t k = 1; k < 8; ++k) {
+                for (std::size_t byte = 0; byte < 256; ++byte)
+                    table[k][byte] = (table[k - 1][byte] >> 8) ^ table[0][table[k - 1][byte] & 0xFF];
+            }
+            return table;
+        }();
+
+        // The CRC register after `size` more bytes, without the initial and final inversion
+        inline uint32_t crc32c_update_scalar(uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+            if constexpr (std::endian::native == std::endian::little) {
+                for (; size >= 8; data += 8, size -= 8) {
+                    uint64_t word;
+                    std::memcpy(&word, data, 8);
+                    word ^= crc;
+                    crc = crc32c_table[7][word & 0xFF] ^ crc32c_table[6][(word >> 8) & 0xFF] ^ crc32c_table[5][(word >> 16) & 0xFF]
+                        ^ crc32c_table[4][(word >> 24) & 0xFF] ^ crc32c_table[3][(word >> 32) & 0xFF] ^ crc32c_table[2][(word >> 40) & 0xFF]
+                        ^ crc32c_table[1][(word >> 48) & 0xFF] ^ crc32c_table[0][word >> 56];
+                }
+            }
+            for (; size; ++data, --size)
+                crc = (crc >> 8) ^ crc32c_table[0][(crc ^ *data) & 0xFF];
+            return crc;
+        }
+
+#if defined(KONCAR_X86_KERNELS) && defined(__x86_64__)
+        // Bytes per stream of the SSE4.2 CRC; three streams hide the three-cycle latency of the crc32 instruction
+        inline constexpr std::size_t crc32c_stream = 1024;
+
+        // x^(8 * crc32c_stream - 33) mod P, reflected: the CRC of one stream multiplied by it with pclmulqdq and
+        // reduced by crc32 is that CRC advanced over the following stream
+        inline constexpr uint32_t crc32c_stream_shift = [] {
+            uint32_t power = 0x80000000;
+            for (std::size_t n = 0; n < 8 * crc32c_stream - 33; ++n)
+                power = power & 1 ? (power >> 1) ^ crc32c_polynomial : power >> 1;
+            return power;
+        }();
+
+        __attribute__((target("sse4.2,pclmul")))
+        inline uint32_t crc32c_advance_sse42(const uint32_t crc) noexcept {
+            const __m128i product = _mm_clmulepi64_si128(_mm_cvtsi32_si128(static_cast<int>(crc)), _mm_cvtsi32_si128(static_cast<int>(crc32c_stream_shift)), 0);
+            return static_cast<uint32_t>(_mm_crc32_u64(0, static_cast<uint64_t>(_mm_cvtsi128_si64(product))));
+        }
+
+        __attribute__((target("sse4.2,pclmul")))
+        inline uint32_t crc32c_update_sse42(uint32_t crc, const uint8_t* data, std::size_t size) noexcept {
+            for (; size >= 3 * crc32c_stream; data += 3 * crc32c_stream, size -= 3 * crc32c_stream) {
+                uint64_t a = crc, b = 0, c = 0;
+                for (std::size_t i = 0; i < crc32c_stream; i += 8) {
+                    uint64_t words[3];
+                    std::memcpy(&words[0], data + i, 8);
+                    std::memcpy(&words[1], data + crc32c_stream + i, 8);
+                    std::memcpy(&words[2], data + 2 * crc32c_stream + i, 8);
+                    a = _mm_crc32_u64(a, words[0]);
+                    b = _mm_crc32_u64(b, words[1]);
+                    c = _mm_crc32_u64(c, words[2]);
+                }
+                // The register is linear: the CRC of a stream started at zero combines by XOR with the advanced CRC before it
+                crc = crc32c_advance_sse42(crc32c_advance_sse42(static_cast<uint32_t>(a)) ^ static_cast<uint32_t>(b)) ^ static_cast<uint32_t>(c);
+            }
+            uint64_t wide = crc;
+            for (; size >= 8; data += 8, size -= 8) {
+                uint64_t word;
+                std::memcpy(&word, data, 8);
+                wide = _mm_crc32_u64(wide, word);
+            }
+            crc = static_cast<uint32_t>(wide);
+            for (; size; ++data, --size)
+                crc = _mm_crc32_u8(crc, *data);
+            return crc;
+        }
+#endif
+
+        inline uint32_t crc32c_update(const uint32_t crc, const uint8_t* data, const std::size_t size) noexcept {
+#if defined(KONCAR_X86_KERNELS) && defined(__x86_64__)
+            static const bool hardware = [] {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("pclmul");
+            }();
+            if (hardware)
+                return crc32c_update_sse42(crc, data, size);
+#endif
+            return crc32c_update_scalar(crc, data, size);
+        }
+
+        // Incremental XXH64, fed in pieces of any size
+        class xxhash64_state {
+        public:
+            explicit xxhash64_state(const uint64_t seed = 0) noexcept
+                : lanes_{ seed + prime1 + prime2, seed + prime2, seed, seed - prime1 }, seed_(seed) {}
+
+            void update(const uint8_t* data, std::size_t size) noexcept {
+                total_ += size;
+                if (buffered_) {
+                    const std::size_t count = std::min(size, sizeof buffer_ - buffered_);
+                    std::memcpy(buffer_ + buffered_, data, count);
+                    buffered_ += count;
+                    data += count;
+                    size -= count;
+                    if (buffered_ < sizeof buffer_)
+                        return;
+                    stripes(buffer_, sizeof buffer_);
+                    buffered_ = 0;
+                }
+                const std::size_t whole = size & ~std::size_t{ 31 };
+                stripes(data, whole);
+                data += whole;
+                size -= whole;
+                if (size)
+                    std::memcpy(buffer_, data, size);
+                buffered_ = size;
+            }
+
+            uint64_t finish() const noexcept {
+                uint64_t hash;
+                if (total_ >= 32) {
+                    hash = std::rotl(lanes_[0], 1) + std::rotl(lanes_[1], 7) + std::rotl(lanes_[2], 12) + std::rotl(lanes_[3], 18);
+                    for (const uint64_t lane : lanes_)
+                        hash = (hash ^ round(0, lane)) * prime1 + prime4;
+                } else {
+                    hash = seed_ + prime5;
+                }
+                hash += total_;
+
+                const uint8_t* data = buffer_;
+                std::size_t size = buffered_;
+                for (; size >= 8; data += 8, size -= 8)
+                    hash = std::rotl(hash ^ round(0, load<uint64_t>(data)), 27) * prime1 + prime4;
+                if (size >= 4) {
+                    hash = std::rotl(hash ^ load<uint32_t>(data) * prime1, 23) * prime2 + prime3;
+                    data += 4;
+                    size -= 4;
+                }
+                for (; size; ++data, --size)
+                    hash = std::rotl(hash ^ *data * prime5, 11) * prime1;
+
+                hash ^= hash >> 33;
+                hash *= prime2;
+                hash ^= hash >> 29;
+                hash *= prime3;
+                return hash ^ (hash >> 32);
+            }
+
+        private:
+            static constexpr uint64_t prime1 = 0x9E3779B185EBCA87;
+            static constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4F;
+            static constexpr uint64_t prime3 = 0x165667B19E3779F9;
+            static constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63;
+            static constexpr uint64_t prime5 = 0x27D4EB2F165667C5;
+
+            // Little-endian load, as XXH64 is defined on little-endian words
+            template <typename Word>
+            static Word load(const uint8_t* data) noexcept {
+                Word word = 0;
+                if constexpr (std::endian::native == std::endian::little) {
+                    std::memcpy(&word, data, sizeof(Word));
+                } else {
+                    for (std::size_t i = 0; i < sizeof(Word); ++i)
+                        word |= static_cast<Word>(data[i]) << (8 * i);
+                }
+                return word;
+            }
+
+            static uint64_t round(const uint64_t lane, const uint64_t input) noexcept {
+                return std::rotl(lane + input * prime2, 31) * prime1;
+            }
+
+            // Whole 32-byte stripes; the lanes stay in registers, as the input bytes could otherwise alias them
+            void stripes(const uint8_t* data, const std::size_t size) noexcept {
+                uint64_t a = lanes_[0], b = lanes_[1], c = lanes_[2], d = lanes_[3];
+                for (std::size_t i = 0; i < size; i += 32) {
+                    a = round(a, load<uint64_t>(data + i));
+                    b = round(b, load<uint64_t>(data + i + 8));
+                    c = round(c, load<uint64_t>(data + i + 16));
+                    d = round(d, load<uint64_t>(data + i + 24));
+                }
+                lanes_[0] = a;
+                lanes_[1] = b;
+                lanes_[2] = c;
+                lanes_[3] = d;
+            }
+
+            uint64_t lanes_[4];
+            uint64_t seed_;
+            uint64_t total_ = 0;
+            uint8_t buffer_[32];
+            std::size_t buffered_ = 0;
+        };
+
+        // Checksum of the bytes coded so far by the fused coders
+        class checksum_state {
+        public:
+            explicit checksum_state(const checksum kind) noexcept : kind_(kind) {}
+
+            void update(const uint8_t* data, const std::size_t size) noexcept {
+                if (kind_ == checksum::crc32c)
+                    crc_ = crc32c_update(crc_, data, size);
+                else
+                    xxhash_.update(data, size);
+            }
+
+            uint64_t value() const noexcept {
+                return kind_ == checksum::crc32c ? ~crc_ : xxhash_.finish();
+            }
+
+        private:
+            checksum kind_;
+            uint32_t crc_ = 0xFFFFFFFF;
+            xxhash64_state xxhash_;
+        };
+
+        // Bytes checksummed and then coded at a time, a whole number of XXH64 stripes. Blocks this small stay in L1
+        // between the two passes, and out-of-order execution overlaps the latency-bound checksum of one block with
+        // the coding of the previous one; larger blocks measured slower, even with the three-stream CRC.
+        inline constexpr std::size_t checksum_block = 512;
+
+    }
+
+    /**
+     * @brief Computes the CRC-32C (Castagnoli) of `data`, continuing from the CRC of the preceding bytes.
+     *
+     * Uses the SSE4.2 crc32 instruction on three interleaved streams combined with pclmulqdq where the CPU supports
+     * them, and slicing-by-8 tables otherwise.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const uint32_t crc = koncar::crc32c(header);
+     * const uint32_t frame_crc = koncar::crc32c(payload, crc);   // CRC of header followed by payload
+     * \endcode
+     */
+    inline uint32_t crc32c(const std::span<const uint8_t> data, const uint32_t crc = 0) noexcept {
+        return ~detail::crc32c_update(~crc, data.data(), data.size());
+    }
+
+    /**
+     * @brief Computes the XXH64 hash of `data` with the given seed.
+     */
+    inline uint64_t xxhash64(const std::span<const uint8_t> data, const uint64_t seed = 0) noexcept {
+        detail::xxhash64_state state(seed);
+        state.update(data.data(), data.size());
+        return state.finish();
+    }
+
+    /**
+     * @brief Converts binary data to a hexadecimal string followed by the hexadecimal checksum of the data.
+     *
+     * The checksum is computed in the same pass as the encoding: every block of 512 bytes is checksummed and then
+     * encoded while it is still in the L1 cache, so the data is read from memory once.
+     *
+     * @param data The vector of binary data to be converted to a hexadecimal string.
+     * @param kind The checksum appended to the text, see koncar::checksum.
+     * @param uppercase Optional flag indicating whether the resulting hexadecimal string should be in uppercase (default is true).
+     * @return The hexadecimal data and checksum, or an empty string if conversion fails.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const std::string hex_string = koncar::binary_to_string(frame, koncar::checksum::crc32c);
+     * // for the bytes of "123456789", hex_string contains "313233343536373839E3069283"
+     * \endcode
+     */
+    inline std::string binary_to_string(const std::vector<uint8_t>& data, const checksum kind, const bool uppercase = true) {
+        try {
+            const std::size_t digits = checksum_digits(kind);
+            std::string result(data.size() * 2 + digits, '\0');
+            detail::checksum_state state(kind);
+            for (std::size_t first = 0; first < data.size(); first += detail::checksum_block) {
+                const std::size_t count = std::min(detail::checksum_block, data.size() - first);
+                state.update(data.data() + first, count);
+                detail::encode_hex(data.data() + first, count, result.data() + 2 * first, uppercase);
+            }
+
+            uint8_t value[8];
+            const uint64_t sum = state.value();
+            for (std::size_t i = 0; i < digits / 2; ++i)
+                value[i] = static_cast<uint8_t>(sum >> (8 * (digits / 2 - 1 - i)));
+            detail::encode_hex(value, digits / 2, result.data() + 2 * data.size(), uppercase);
+            return result;
+        } catch (const std::exception& e) {
+            // Handle the exception
+            detail::report_diagnostic(diagnostic_kind::conversion_error, {}, e.what());
+            // Return an empty string to indicate failure
+            return "";
+        }
+    }
+
+    /**
+     * @brief Converts a hexadecimal string ending in a checksum to binary data, verifying the checksum.
+     *
+     * The inverse of the checksummed koncar::binary_to_string: the trailing `checksum_digits(kind)` digits are the
+     * checksum of the bytes before them. Every block is decoded and then checksummed while still in the L1 cache.
+     * Invalid characters, an odd length, text shorter than the checksum and a checksum which does not match the
+     * data throw std::invalid_argument, which is caught and reported like in the unchecked version.
+     *
+     * @param str The hexadecimal data followed by its checksum.
+     * @param kind The checksum at the end of the text.
+     * @return The data without the checksum, or an empty vector if conversion or verification fails.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const std::vector<uint8_t> frame = koncar::string_to_binary(hex_string, koncar::checksum::crc32c);
+     * \endcode
+     */
+    inline std::vector<uint8_t> string_to_binary(const std::string& str, const checksum kind) {
+        try {
+            const std::size_t digits = checksum_digits(kind);
+            if (str.size() & 1) {
+                throw std::invalid_argument("Input string length must be even");
+            }
+            if (str.size() < digits) {
+                throw std::invalid_argument("Input string is shorter than its checksum");
+            }
+
+            const std::size_t size = (str.size() - digits) / 2;
+            std::vector<uint8_t> result(size);
+            detail::checksum_state state(kind);
+            const auto decode = [&](const char* text, const std::size_t count, uint8_t* out) {
+                if (const char* invalid = detail::decode_hex(text, 2 * count, out)) {
+                    throw std::invalid_argument("Invalid hexadecimal character: " + std::string(1, *invalid));
+                }
+            };
+            for (std::size_t first = 0; first < size; first += detail::checksum_block) {
+                const std::size_t count = std::min(detail::checksum_block, size - first);
+                decode(str.data() + 2 * first, count, result.data() + first);
+                state.update(result.data() + first, count);
+            }
+
+            uint8_t value[8];
+            decode(str.data() + 2 * size, digits / 2, value);
+            uint64_t stored = 0;
+            for (std::size_t i = 0; i < digits / 2; ++i)
+                stored = stored << 8 | value[i];
+            if (const uint64_t computed = state.value(); stored != computed) {
+                char message[80];
+                std::snprintf(message, sizeof message, "Checksum mismatch: stored %0*llX, computed %0*llX", static_cast<int>(digits),
+                              static_cast<unsigned long long>(stored), static_cast<int>(digits), static_cast<unsigned long long>(computed));
+                throw std::invalid_argument(message);
+            }
+            return result;
+        } catch (const std::exception& e) {
+            // Handle the exception
+            detail::report_diagnostic(diagnostic_kind::conversion_error, {}, e.what());
+            // Return an empty vector to indicate failure
+            return {};
+        }
+    }
+
+    // Task 2.1 - Parallel version
+    //****************************************************************
+    /**
+     * @brief Converts binary data to a hexadecimal string representation, encoding large inputs in parallel.
+     *
+     * The output is sized once and disjoint slices of the input are encoded directly into it by the policy's
+     * koncar::executor (koncar::default_executor() by default). Inputs shorter than `policy.threshold` bytes are
+     * encoded on the calling thread. The result and the error handling are the same as for the sequential version.
+     *
+     * @param policy The execution policy, with its parallel threshold, grain, thread limit and executor.
+     * @param data The vector of binary data to be converted to a hexadecimal string.
+     * @param uppercase Optional flag indicating whether the resulting hexadecimal string should be in uppercase (default is true).
+     * @return A hexadecimal string representation of the input binary data, or an empty string if conversion fails.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const std::string hex_string = koncar::binary_to_string(koncar::execution::par, firmware_image);
+     * \endcode
+     */
+    inline std::string binary_to_string(const execution::parallel_policy& policy, const std::vector<uint8_t>& data, const bool uppercase = true) {
+        try {
+            std::string result(data.size() * 2, '\0');
+            const auto encode = [&](const std::size_t first, const std::size_t last) {
+                detail::encode_hex(data.data() + first, last - first, result.data() + 2 * first, uppercase);
+            };
+            if (data.size() < policy.threshold)
+                encode(0, data.size());
+            else
+                detail::parallel_slices(data.size(), policy, encode);
+            return result;
+        } catch (const std::exception& e) {
+            // Handle the exception
+            detail::report_diagnostic(diagnostic_kind::conversion_error, {}, e.what());
+            // Return an empty string to indicate failure
+            return "";
+        }
+    }
+    
+    // Files - Memory-mapped input
+    //****************************************************************
+    /**
+     * @brief Read-only view of a whole file, memory-mapped where the platform supports it.
+     *
+     * On POSIX systems the file is mapped with mmap and the kernel is advised that it will be read sequentially;
+     * elsewhere it is read into memory. Empty files are not mapped and yield an empty view.
+     * Construction throws std::filesystem::filesystem_error if the file cannot be opened, inspected or mapped.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const koncar::mapped_file file("firmware.bin");
+     * const std::string hex_string = koncar::str_concat(koncar::hex_view(file.bytes()));
+     * \endcode
+     */
+    class mapped_file {
+    public:
+        mapped_file() noexcept = default;
+
+        explicit mapped_file(const fs::path& path) {
+#ifdef KONCAR_POSIX_FILES
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                throw fs::filesystem_error("Cannot open file", path, std::error_code(errno, std::system_category()));
+            struct stat status;
+            if (::fstat(fd, &status) != 0) {
+                const int error = errno;
+                ::close(fd);
+                throw fs::filesystem_error("Cannot inspect file", path, std::error_code(error, std::system_category()));
+            }
+            size_ = static_cast<std::size_t>(status.st_size);
+            if (size_ != 0) {
+                void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address == MAP_FAILED) {
+                    const int error = errno;
+                    ::close(fd);
+                    throw fs::filesystem_error("Cannot map file", path, std::error_code(error, std::system_category()));
+                }
+                ::madvise(address, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<const std::uint8_t*>(address);
+            }
+            ::close(fd);
+#else
+            std::ifstream stream(path, std::ios::binary);
+            if (!stream)
+                throw fs::filesystem_error("Cannot open file", path, std::make_error_code(std::errc::io_error));
+            buffer_.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+            data_ = reinterpret_cast<const std::uint8_t*>(buffer_.data());
+            size_ = buffer_.size();
+#endif
+        }
+
+        mapped_file(mapped_file&& other) noexcept { swap(other); }
+
+        mapped_file& operator=(mapped_file&& other) noexcept {
+            mapped_file(std::move(other)).swap(*this);
+            return *this;
+        }
+
+        ~mapped_file() {
+#ifdef KONCAR_POSIX_FILES
+            if (data_)
+                ::munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+        }
+
+        void swap(mapped_file& other) noexcept {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+#ifndef KONCAR_POSIX_FILES
+            buffer_.swap(other.buffer_);
+#endif
+        }
+
+        std::size_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+
+        // The contents as bytes
+        std::span<const std::uint8_t> bytes() const noexcept { return { data_, size_ }; }
+
+        // The contents as characters
+        std::string_view text() const noexcept { return { reinterpret_cast<const char*>(data_), size_ }; }
+
+    private:
+        const std::uint8_t* data_ = nullptr;
+        std::size_t size_ = 0;
+#ifndef KONCAR_POSIX_FILES
+        std::string buffer_;
+#endif
+    };
+
+    // Strings - Record-oriented hexadecimal decoding
+    //****************************************************************
+    namespace detail {
+        struct hex_records_builder;
+    }
+
+    /**
+     * @brief Binary records decoded from newline-delimited hexadecimal text, stored back to back in one arena.
+     *
+     * Record `i` holds line `i + 1` of the text, so record indices and line numbers stay aligned. Blank lines and
+     * lines which are not valid hexadecimal give empty records; the numbers of the latter are listed in `bad_lines`.
+     * `offsets` has one entry more than there are records: record `i` is `bytes()[offsets[i], offsets[i + 1])`.
+     */
+    class hex_records {
+    public:
+        std::size_t size() const noexcept { return offsets_.size() - 1; }
+        bool empty() const noexcept { return size() == 0; }
+
+        std::span<const std::uint8_t> operator[](const std::size_t index) const noexcept {
+            return { bytes_.get() + offsets_[index], offsets_[index + 1] - offsets_[index] };
+        }
+
+        // All records, back to back
+        std::span<const std::uint8_t> bytes() const noexcept { return { bytes_.get(), offsets_.back() }; }
+
+        std::span<const std::size_t> offsets() const noexcept { return offsets_; }
+
+        // Line numbers (counted from 1) of the lines which were not valid hexadecimal, in increasing order
+        std::span<const std::uint64_t> bad_lines() const noexcept { return bad_lines_; }
+
+    private:
+        friend struct detail::hex_records_builder;
+
+        std::unique_ptr<std::uint8_t[]> bytes_;
+        std::vector<std::size_t> offsets_ = { 0 };
+        std::vector<std::uint64_t> bad_lines_;
+    };
+
+    namespace detail {
+
+        inline constexpr bool is_blank(const char c) noexcept {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+        }
+
+        struct hex_records_builder {
+            // Slices of the text which start at line beginnings; every slice is decoded by one task
+            struct slice {
+                std::size_t begin = 0;
+                std::size_t end = 0;
+                std::vector<std::size_t> line_ends;     // position of the newline (or the end) of every line, from the first pass
+                std::size_t first_line = 0;
+                std::size_t first_byte = 0;
+                std::size_t bytes = 0;       // reserved by the first pass
+                std::size_t used = 0;        // written by the second pass; less than `bytes` if the slice has bad lines
+                std::vector<std::uint64_t> bad_lines;
+            };
+
+
+            // The line without surrounding blanks, and the number of blanks removed in front
+            static std::pair<std::string_view, std::size_t> trim(std::string_view line) noexcept {
+                std::size_t leading = 0;
+                for (; !line.empty() && is_blank(line.front()); line.remove_prefix(1))
+                    ++leading;
+                while (!line.empty() && is_blank(line.back()))
+                    line.remove_suffix(1);
+                return { line, leading };
+            }
+
+            static hex_records build(const std::string_view text, const execution::parallel_policy& policy, const std::string_view source) {
+                executor& pool = policy.executor ? *policy.executor : default_executor();
+                std::size_t count = 1;
+                if (text.size() >= policy.threshold) {
+                    const std::size_t max_tasks = policy.max_threads ? policy.max_threads : pool.concurrency() + (pool.owns_current_thread() ? 0 : 1);
+                    count = std::clamp<std::size_t>(text.size() / std::max<std::size_t>(policy.grain, 1), 1, std::max<std::size_t>(max_tasks, 1));
+                }
+
+                // Each slice owns the lines which start in its share of the text
+                std::vector<slice> slices(count);
+                for (std::size_t i = 1; i < count; ++i) {
+                    const std::size_t target = text.size() / count * i;
+                    const std::size_t newline = text.find('\n', target - 1);
+                    slices[i].begin = std::max(slices[i - 1].begin, newline == std::string_view::npos ? text.size() : newline + 1);
+                    slices[i - 1].end = slices[i].begin;
+                }
+                slices.back().end = text.size();
+
+                execution::parallel_policy per_slice = policy;
+                per_slice.executor = &pool;
+                per_slice.grain = 1;
+                const auto for_each_slice = [&](const auto& function) {
+                    parallel_slices(count, per_slice, [&](const std::size_t first, const std::size_t last) {
+                        for (std::size_t i = first; i < last; ++i)
+                            function(slices[i]);
+                    });
+                };
+
+                // First pass: find the lines and count the bytes they decode to
+                for_each_slice([&](slice& part) {
+                    for (std::size_t begin = part.begin; begin < part.end;) {
+                        const void* newline = std::memchr(text.data() + begin, '\n', part.end - begin);
+                        const std::size_t end = newline ? static_cast<std::size_t>(static_cast<const char*>(newline) - text.data()) : part.end;
+                        const std::size_t digits = trim(text.substr(begin, end - begin)).first.size();
+                        part.bytes += digits & 1 ? 0 : digits / 2;
+                        part.line_ends.push_back(end);
+                        begin = end + 1;
+                    }
+                });
+
+                std::size_t lines = 0, bytes = 0;
+                for (slice& part : slices) {
+                    part.first_line = lines;
+                    part.first_byte = bytes;
+                    lines += part.line_ends.size();
+                    bytes += part.bytes;
+                }
+
+                hex_records records;
+                records.bytes_ = std::make_unique_for_overwrite<std::uint8_t[]>(std::max<std::size_t>(bytes, 1));
+                records.offsets_.assign(lines + 1, 0);
+                std::uint8_t* const arena = records.bytes_.get();
+
+                // Second pass: decode every line into its place in the arena
+                for_each_slice([&](slice& part) {
+                    std::size_t line_index = part.first_line;
+                    std::size_t cursor = part.first_byte;
+                    std::size_t begin = part.begin;
+                    for (const std::size_t end : part.line_ends) {
+                        records.offsets_[line_index++] = cursor;
+                        const auto [digits, leading] = trim(text.substr(begin, end - begin));
+                        begin = end + 1;
+                        std::string message;
+                        if (digits.size() & 1) {
+                            message = str_concat("line ", line_index, ": odd number of hexadecimal digits");
+                        } else if (const char* invalid = decode_hex(digits.data(), digits.size(), arena + cursor)) {
+                            message = str_concat("line ", line_index, ": invalid hexadecimal character at column ",
+                                                 static_cast<std::size_t>(invalid - digits.data()) + leading + 1);
+                        } else {
+                            cursor += digits.size() / 2;
+                            continue;
+                        }
+                        part.bad_lines.push_back(line_index);
+                        report_diagnostic(diagnostic_kind::conversion_error, source, message);
+                    }
+                    part.used = cursor - part.first_byte;
+                });
+
+                // Bad lines leave unused space at the end of their slice, which is closed here
+                std::size_t shift = 0;
+                for (const slice& part : slices) {
+                    if (shift) {
+                        std::memmove(arena + part.first_byte - shift, arena + part.first_byte, part.used);
+                        for (std::size_t i = part.first_line; i < part.first_line + part.line_ends.size(); ++i)
+                            records.offsets_[i] -= shift;
+                    }
+                    shift += part.bytes - part.used;
+                    records.bad_lines_.insert(records.bad_lines_.end(), part.bad_lines.begin(), part.bad_lines.end());
+                }
+                records.offsets_[lines] = bytes - shift;
+                return records;
+            }
+        };
+
+    }
+
+    /**
+     * @brief Decodes newline-delimited hexadecimal text, one record per line, in parallel into one contiguous arena.
+     *
+     * The text is split into one share per thread at line boundaries. A first pass counts the lines and the bytes
+     * they decode to, so that every line's place in the arena and in the offsets index is known; a second pass
+     * decodes every line in place with koncar::active_hex_kernel(). Blanks around a line (including the '\r' of
+     * CRLF line ends) are ignored.
+     *
+     * @param text The hexadecimal text, one record per line.
+     * @param policy Texts shorter than `policy.threshold` characters are decoded on the calling thread.
+     * @return The records; lines which are not valid hexadecimal give empty records and are listed in `bad_lines()`.
+     *
+     * @details A bad line does not stop the run: it is reported to koncar::default_diagnostics() with its line number
+     * and decoding continues with the next line.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const koncar::hex_records frames = koncar::decode_hex_records("BAAD\nF00D\n");
+     * // frames.size() == 2, frames[1] contains { 0xF0, 0x0D }
+     * \endcode
+     */
+    inline hex_records decode_hex_records(const std::string_view text, const execution::parallel_policy& policy = {}) {
+        return detail::hex_records_builder::build(text, policy, {});
+    }
+
+    /**
+     * @brief Memory-maps `file` and decodes it with koncar::decode_hex_records; bad lines are reported with the file's path.
+     *
+     * Throws std::filesystem::filesystem_error if the file cannot be mapped.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const koncar::hex_records frames = koncar::decode_hex_file("trace.hex", koncar::execution::par);
+     * for (std::size_t i = 0; i < frames.size(); ++i)
+     *     process(frames[i]);
+     * \endcode
+     */
+    inline hex_records decode_hex_file(const fs::path& file, const execution::parallel_policy& policy = {}) {
+        const mapped_file mapped(file);
+        return detail::hex_records_builder::build(mapped.text(), policy, file.string());
+    }
+
+#ifdef KONCAR_POSIX_FILES
+    // Files - Pipelined descriptor conversion
+    //****************************************************************
+    /**
+     * @brief Options for koncar::descriptor_pipeline.
+     *
+     * @param block_size Size of every input and output buffer in bytes.
+     * @param blocks Number of input buffers and of output buffers; at least two, so that I/O overlaps the conversion.
+     */
+    struct pipeline_options {
+        std::size_t block_size = std::size_t{ 1 } << 20;
+        std::size_t blocks = 4;
+    };
+
+    struct pipeline_stats {
+        std::uint64_t bytes_read = 0;
+        std::uint64_t bytes_written = 0;
+    };
+
+    /**
+     * @brief Converts the data read from one file descriptor and writes the result to another, with reading,
+     * converting and writing running as overlapped stages.
+     *
+     * A reader thread fills a ring of page-aligned input buffers, the calling thread converts them into a ring of
+     * output buffers and a writer thread writes those out, so for pipes and sockets the time spent waiting for I/O
+     * is hidden behind the conversion. The stages hand whole buffers to each other, one lock per buffer.
+     *
+     * @details `run(transform)` calls `transform(std::span<const std::uint8_t> block, descriptor_pipeline::writer& out)`
+     * for every block read, in order, and once more with an empty block at the end of the input. Input blocks have
+     * whatever size a read returned. The first exception thrown by a stage (std::system_error for read and write
+     * errors) stops reading and converting and is rethrown by `run`; the output converted before it is still written.
+     * Descriptors are not closed. The reader polls its descriptor, so it notices a failure while waiting on an idle
+     * pipe or socket.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::descriptor_pipeline pipeline(socket_fd, STDOUT_FILENO);
+     * pipeline.run([](std::span<const std::uint8_t> block, koncar::descriptor_pipeline::writer& out) {
+     *     std::memcpy(out.grow(block.size()), block.data(), block.size());
+     * });
+     * \endcode
+     */
+    class descriptor_pipeline {
+    public:
+        // Output side handed to the conversion stage; bytes go out in the order they are added
+        class writer {
+        public:
+            /**
+             * @brief Returns room for `count` bytes (at most the block size) at the end of the output.
+             * @throws std::length_error If `count` exceeds the block size.
+             */
+            char* grow(const std::size_t count) {
+                if (count > pipeline_.options_.block_size)
+                    throw std::length_error("descriptor_pipeline: write larger than a block");
+                if (!block_ || used_ + count > pipeline_.options_.block_size) {
+                    submit();
+                    block_ = pipeline_.acquire_output();
+                }
+                char* room = block_ + used_;
+                used_ += count;
+                return room;
+            }
+
+            // Takes back the last `count` bytes handed out by grow
+            void shrink(const std::size_t count) noexcept { used_ -= count; }
+
+            void put(const char c) { *grow(1) = c; }
+
+            void put(std::string_view text) {
+                while (!text.empty()) {
+                    const std::size_t count = std::min(text.size(), pipeline_.options_.block_size);
+                    std::memcpy(grow(count), text.data(), count);
+                    text.remove_prefix(count);
+                }
+            }
+
+            std::size_t block_size() const noexcept { return pipeline_.options_.block_size; }
+
+        private:
+            friend class descriptor_pipeline;
+
+            explicit writer(descriptor_pipeline& pipeline) noexcept : pipeline_(pipeline) {}
+
+            void submit() {
+                if (block_)
+                    pipeline_.submit_output(used_);
+                block_ = nullptr;
+                used_ = 0;
+            }
+
+            descriptor_pipeline& pipeline_;
+            char* block_ = nullptr;
+            std::size_t used_ = 0;
+        };
+
+        /**
+         * @throws std::invalid_argument If the block size is zero or there are fewer than two blocks.
+         * @throws std::system_error If a descriptor is negative.
+         */
+        descriptor_pipeline(const int input, const int output, const pipeline_options& options = {})
+            : input_(input), output_(output), options_(options) {
+            // poll skips negative descriptors instead of reporting them
+            if (input < 0 || output < 0)
+                throw std::system_error(EBADF, std::system_category(), "descriptor_pipeline");
+            if (options.block_size == 0 || options.blocks < 2)
+                throw std::invalid_argument("descriptor_pipeline needs a block size and at least two blocks");
+            for (auto* ring : { &inputs_, &outputs_ }) {
+                ring->reserve(options.blocks);
+                for (std::size_t i = 0; i < options.blocks; ++i)
+                    ring->push_back({ buffer(static_cast<char*>(::operator new(options.block_size, alignment))), 0 });
+            }
+        }
+
+        descriptor_pipeline(const descriptor_pipeline&) = delete;
+        descriptor_pipeline& operator=(const descriptor_pipeline&) = delete;
+
+        template <typename Transform>
+        pipeline_stats run(Transform&& transform) {
+            reset();
+            std::thread reader([this] { stage([this] { read_loop(); }); });
+            std::thread writer_thread([this] { stage([this] { write_loop(); }); });
+
+            writer out(*this);
+            stage([&] {
+                for (;;) {
+                    const std::optional<std::span<const std::uint8_t>> block = take_input();
+                    if (!block)
+                        return;
+                    transform(*block, out);
+                    if (block->empty())
+                        return;
+                    release_input();
+                }
+            });
+            // What was converted before a failure is written as well
+            stage([&] { out.submit(); });
+            {
+                std::lock_guard lock(mutex_);
+                output_done_ = true;
+                changed_.notify_all();
+            }
+
+            reader.join();
+            writer_thread.join();
+            if (error_)
+                std::rethrow_exception(std::exchange(error_, nullptr));
+            return stats_;
+        }
+
+    private:
+        static constexpr std::align_val_t alignment{ 4096 };
+
+        struct buffer_deleter {
+            void operator()(char* data) const noexcept { ::operator delete(data, alignment); }
+        };
+        using buffer = std::unique_ptr<char[], buffer_deleter>;
+
+        struct slot {
+            buffer data;
+            std::size_t size;
+        };
+
+        void reset() {
+            read_ = consumed_ = submitted_ = written_ = 0;
+            output_done_ = false;
+            failed_.store(false, std::memory_order_relaxed);
+            error_ = nullptr;
+            stats_ = {};
+        }
+
+        // Runs one stage, turning an exception into a stop of the whole pipeline
+        template <typename Function>
+        void stage(Function&& function) noexcept {
+            try {
+                function();
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+                failed_.store(true, std::memory_order_relaxed);
+                changed_.notify_all();
+            }
+        }
+
+        // Waits until `fd` is ready for `events`; false if `abortable` and the pipeline has failed meanwhile
+        bool wait_ready(const int fd, const short events, const bool abortable) const {
+            for (;;) {
+                if (abortable && failed_.load(std::memory_order_relaxed))
+                    return false;
+                pollfd request{ fd, events, 0 };
+                const int ready = ::poll(&request, 1, 100);
+                if (ready > 0)
+                    return true;
+                if (ready < 0 && errno != EINTR)
+                    throw std::system_error(errno, std::system_category(), "poll");
+            }
+        }
+
+        void read_loop() {
+            for (std::size_t index = 0;; ++index) {
+                {
+                    std::unique_lock lock(mutex_);
+                    changed_.wait(lock, [&] { return failed_.load(std::memory_order_relaxed) || read_ - consumed_ < inputs_.size(); });
+                    if (failed_.load(std::memory_order_relaxed))
+                        return;
+                }
+                slot& target = inputs_[index % inputs_.size()];
+                ssize_t count;
+                do {
+                    if (!wait_ready(input_, POLLIN, true))
+                        return;
+                    count = ::read(input_, target.data.get(), options_.block_size);
+                } while (count < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK));
+                if (count < 0)
+                    throw std::system_error(errno, std::system_category(), "read");
+
+                std::lock_guard lock(mutex_);
+                target.size = static_cast<std::size_t>(count);
+                stats_.bytes_read += target.size;
+                ++read_;
+                changed_.notify_all();
+                if (count == 0)
+                    return;
+            }
+        }
+
+        void write_loop() {
+            for (;;) {
+                std::size_t index;
+                {
+                    std::unique_lock lock(mutex_);
+                    changed_.wait(lock, [&] { return written_ < submitted_ || output_done_; });
+                    if (written_ == submitted_)
+                        return;
+                    index = written_;
+                }
+                const slot& source = outputs_[index % outputs_.size()];
+                for (std::size_t done = 0; done < source.size;) {
+                    wait_ready(output_, POLLOUT, false);
+                    const ssize_t count = ::write(output_, source.data.get() + done, source.size - done);
+                    if (count < 0) {
+                        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+                            continue;
+                        throw std::system_error(errno, std::system_category(), "write");
+                    }
+                    done += static_cast<std::size_t>(count);
+                }
+
+                std::lock_guard lock(mutex_);
+                stats_.bytes_written += source.size;
+                ++written_;
+                changed_.notify_all();
+            }
+        }
+
+        // The next block read, empty at the end of the input, or nothing if the pipeline has failed
+        std::optional<std::span<const std::uint8_t>> take_input() {
+            std::unique_lock lock(mutex_);
+            changed_.wait(lock, [&] { return failed_.load(std::memory_order_relaxed) || consumed_ < read_; });
+            if (failed_.load(std::memory_order_relaxed))
+                return std::nullopt;
+            const slot& source = inputs_[consumed_ % inputs_.size()];
+            return std::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(source.data.get()), source.size);
+        }
+
+        void release_input() {
+            std::lock_guard lock(mutex_);
+            ++consumed_;
+            changed_.notify_all();
+        }
+
+        char* acquire_output() {
+            std::unique_lock lock(mutex_);
+            changed_.wait(lock, [&] { return failed_.load(std::memory_order_relaxed) || submitted_ - written_ < outputs_.size(); });
+            if (failed_.load(std::memory_order_relaxed))
+                throw std::runtime_error("descriptor_pipeline stopped");
+            return outputs_[submitted_ % outputs_.size()].data.get();
+        }
+
+        void submit_output(const std::size_t size) {
+            std::lock_guard lock(mutex_);
+            outputs_[submitted_ % outputs_.size()].size = size;
+            ++submitted_;
+            changed_.notify_all();
         }
-    }
-    
-    // Task 2.2
-    //****************************************************************
+
+        const int input_;
+        const int output_;
+        const pipeline_options options_;
+        std::vector<slot> inputs_;
+        std::vector<slot> outputs_;
+
+        std::mutex mutex_;
+        std::condition_variable changed_;
+        // Blocks read, converted, submitted for writing and written since the start of the run
+        std::size_t read_ = 0;
+        std::size_t consumed_ = 0;
+        std::size_t submitted_ = 0;
+        std::size_t written_ = 0;
+        bool output_done_ = false;
+        std::atomic<bool> failed_{ false };
+        std::exception_ptr error_;
+        pipeline_stats stats_;
+    };
+
     /**
-     * @brief Converts a hexadecimal string to binary data.
-     *
-     * This function takes a hexadecimal string and converts it into a vector of binary data.
-     * Each pair of hexadecimal characters in the input string represents one byte of binary data,
-     * which is then appended to the output vector.
-     * If the input string contains invalid hexadecimal characters or results in bytes outside the range [0, 255],
-     * or if the input string does not contain an even number of characters, exception of type std::invalid_argument if thrown. 
-     * Any exceptions thrown during the conversion process are caught locally, and an empty vector is returned
-     * to indicate failure.
-     *
-     * @param str The hexadecimal string to be converted to binary data.
-     * @return A vector of binary data representing the input hexadecimal string, or an empty vector if conversion fails.
-     *
-     * @details This function iterates through the input string, extracting pairs of hexadecimal characters
-     * and converting them into their corresponding binary representation. Each byte is then pushed into the output vector.
-     * It checks for the even length of the input string and ensures that each character in the substring
-     * contains valid hexadecimal characters. Any invalid characters or odd-length input strings result in an exception,
-     * which is caught and handled.
+     * @brief Hex-encodes everything read from `input` and writes the text to `output` through a koncar::descriptor_pipeline.
      *
      * Example usage:
      * \code{.cpp}
-     * const std::string hex_string = "BAADF00D";
-     * std::vector<uint8_t> binary_data = koncar::string_to_binary(hex_string);
-     * // binary_data contains { 0xBA, 0xAD, 0xF0, 0x0D }
+     * const koncar::pipeline_stats stats = koncar::hex_encode_stream(socket_fd, STDOUT_FILENO);
      * \endcode
      */
-    std::vector<uint8_t> string_to_binary(const std::string& str) {
-        try {
-            // Check if the input string has an even length
-            if (str.size() & 1) {
-                throw std::invalid_argument("Input string length must be even");
+    inline pipeline_stats hex_encode_stream(const int input, const int output, const bool uppercase = true, const pipeline_options& options = {}) {
+        if (options.block_size < 2)
+            throw std::invalid_argument("hex_encode_stream needs blocks of at least two bytes");
+        descriptor_pipeline pipeline(input, output, options);
+        return pipeline.run([&](const std::span<const std::uint8_t> block, descriptor_pipeline::writer& out) {
+            for (std::size_t done = 0; done < block.size();) {
+                const std::size_t count = std::min(block.size() - done, out.block_size() / 2);
+                detail::encode_hex(block.data() + done, count, out.grow(2 * count), uppercase);
+                done += count;
             }
-        
-            std::vector<uint8_t> result;
-            for (size_t i = 0; i < str.size(); i += 2) {
-                std::string substr = str.substr(i, 2);
-                // Check if the substring contains valid hexadecimal characters
-                for (const char c : substr) {
-                    if (!std::isxdigit(c)) {
-                        throw std::invalid_argument("Invalid hexadecimal character: " + std::string(1, c));
+        });
+    }
+
+    /**
+     * @brief Decodes hexadecimal text read from `input` and writes the bytes to `output` through a koncar::descriptor_pipeline.
+     *
+     * Whitespace anywhere in the text is ignored, so wrapped output such as `xxd -p` decodes as well.
+     *
+     * @throws std::invalid_argument On a character which is neither a hexadecimal digit nor whitespace (with its offset
+     * in the input), or an odd number of digits. The bytes decoded before the error are written.
+     */
+    inline pipeline_stats hex_decode_stream(const int input, const int output, const pipeline_options& options = {}) {
+        descriptor_pipeline pipeline(input, output, options);
+        std::uint64_t offset = 0;
+        int pending = -1;   // a digit waiting for the second digit of its byte
+        const auto invalid = [&](const std::size_t position) {
+            return std::invalid_argument(str_concat("Invalid hexadecimal character at offset ", offset + position));
+        };
+        const auto whitespace = [](const char c) { return c == '\n' || detail::is_blank(c); };
+
+        return pipeline.run([&](const std::span<const std::uint8_t> block, descriptor_pipeline::writer& out) {
+            if (block.empty()) {
+                if (pending >= 0)
+                    throw std::invalid_argument("Odd number of hexadecimal digits");
+                return;
+            }
+            const char* text = reinterpret_cast<const char*>(block.data());
+            for (std::size_t i = 0; i < block.size();) {
+                if (whitespace(text[i])) {
+                    ++i;
+                } else if (pending >= 0) {
+                    const std::uint8_t low = detail::hex_values[static_cast<unsigned char>(text[i])];
+                    if (low > 15)
+                        throw invalid(i);
+                    out.put(static_cast<char>(pending << 4 | low));
+                    pending = -1;
+                    ++i;
+                } else {
+                    // Hexadecimal digits all lie above ' ', so a run ends at whitespace or at a control character
+                    std::size_t end = i;
+                    while (end < block.size() && static_cast<unsigned char>(text[end]) > ' ')
+                        ++end;
+                    if (end == i)
+                        throw invalid(i);
+                    const std::size_t even = (end - i) & ~std::size_t{ 1 };
+                    for (std::size_t done = 0; done < even;) {
+                        const std::size_t count = std::min(even - done, 2 * out.block_size()) & ~std::size_t{ 1 };
+                        const char* run = text + i + done;
+                        if (const char* bad = detail::decode_hex(run, count, reinterpret_cast<std::uint8_t*>(out.grow(count / 2)))) {
+                            // Only the bytes before the invalid pair are kept
+                            out.shrink(count / 2 - static_cast<std::size_t>(bad - run) / 2);
+                            throw invalid(static_cast<std::size_t>(bad - text));
+                        }
+                        done += count;
+                    }
+                    if (even != end - i) {
+                        pending = detail::hex_values[static_cast<unsigned char>(text[end - 1])];
+                        if (pending > 15)
+                            throw invalid(end - 1);
                     }
+                    i = end;
                 }
-                std::istringstream iss(substr);
-                int byte;
-                iss >> std::hex >> byte;
-                result.push_back(static_cast<uint8_t>(byte));
             }
-            return result;
-        } catch (const std::exception& e) {
-            // Handle the exception
-            std::cerr << "Error: " << e.what() << std::endl;
-            // Return an empty vector to indicate failure
-            return {};
-        }
+            offset += block.size();
+        });
     }
+#endif
 
     // Task 3 - Version 1
     //****************************************************************
@@ -197,7 +5631,7 @@ namespace koncar {
      *
      * @details This function traverses the directory structure specified by the input path, including all subdirectories,
      * and computes the cumulative size of all files encountered. It considers both files and directories in the calculation.
-     * Any errors encountered during traversal or while obtaining file sizes are caught and output to std::cerr.
+     * Any errors encountered during traversal or while obtaining file sizes are caught and reported to koncar::default_diagnostics().
      *
      * Example usage:
      * \code{.cpp}
@@ -206,7 +5640,7 @@ namespace koncar {
      * // total_size contains the combined size of all files and directories within the specified directory and its subdirectories
      * \endcode
      */
-    uint64_t directory_size(const fs::path& path) {
+    inline uint64_t directory_size(const fs::path& path) {
         uint64_t size = 0;
         try {
             for (const auto& entry : fs::recursive_directory_iterator(path)) {
@@ -214,12 +5648,12 @@ namespace koncar {
                     size += fs::file_size(entry);
                 } catch (const fs::filesystem_error& ex) {
                     // Handle error while getting file size
-                    std::cerr << "Error getting file size: " << ex.what() << std::endl;
+                    detail::report_diagnostic(diagnostic_kind::file_size_error, {}, ex.what());
                 }
             }
         } catch (const fs::filesystem_error& ex) {
             // Handle error while iterating over directory
-            std::cerr << "Error iterating directory: " << ex.what() << std::endl;
+            detail::report_diagnostic(diagnostic_kind::directory_error, {}, ex.what());
         }
         return size;
     }
@@ -239,7 +5673,7 @@ namespace koncar {
      * @details This function recursively traverses the directory structure starting from the input path,
      * considering both files and directories in the computation of the total size.
      * When encountering a directory, it recursively calls itself to include the size of subdirectories.
-     * Any errors encountered during traversal or while processing entries are caught and output to std::cerr.
+     * Any errors encountered during traversal or while processing entries are caught and reported to koncar::default_diagnostics().
      *
      * Example usage:
      * \code{.cpp}
@@ -248,7 +5682,7 @@ namespace koncar {
      * // total_size contains the combined size of all files and directories within the specified directory and its subdirectories
      * \endcode
      */
-    uint64_t directory_size_recursive(const fs::path& path) {
+    inline uint64_t directory_size_recursive(const fs::path& path) {
         uint64_t size = 0;
         try {
             for (const auto& entry : fs::directory_iterator(path)) {
@@ -261,14 +5695,900 @@ namespace koncar {
                     }
                 } catch (const fs::filesystem_error& ex) {
                     // Handle error while processing the current entry
-                    std::cerr << "Error processing entry: " << entry.path() << ": " << ex.what() << std::endl;
+                    detail::report_diagnostic(diagnostic_kind::entry_error, entry.path().string(), ex.what());
                 }
             }
         } catch (const fs::filesystem_error& ex) {
             // Handle error while iterating over directory
-            std::cerr << "Error iterating directory: " << path << ": " << ex.what() << std::endl;
+            detail::report_diagnostic(diagnostic_kind::directory_error, path.string(), ex.what());
         }
         return size;
     }
     
+    // Task 3 - Version 3
+    //****************************************************************
+    /**
+     * @brief Calculates the total size of all files within a directory and its subdirectories, scanning directories in parallel.
+     *
+     * Every directory is scanned by its own task on the policy's koncar::executor (koncar::default_executor() by default),
+     * so large trees on fast storage are traversed by all workers at once. Errors that occur during traversal or while
+     * processing individual entries are handled.
+     *
+     * @param path The path to the directory for which the size is to be calculated.
+     * @param policy Selects the executor; the element thresholds of the policy do not apply to directory traversal.
+     * @return The total size, in bytes, of all regular files within the specified directory and its subdirectories.
+     *
+     * @details Regular files are counted, following symbolic links to files like Version 2. Symbolic links to directories
+     * are not descended into, like Version 1, so link cycles cannot make the traversal run forever.
+     * Any errors encountered during traversal or while processing entries are caught and reported to koncar::default_diagnostics().
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const koncar::fs::path dir_path = "Path\\ToDirectory";
+     * const uint64_t total_size = koncar::directory_size(dir_path, koncar::execution::par);
+     * // total_size contains the combined size of all files within the specified directory and its subdirectories
+     * \endcode
+     */
+    inline uint64_t directory_size(const fs::path& path, const execution::parallel_policy& policy) {
+        std::atomic<uint64_t> total{ 0 };
+        task_group group(policy.executor ? *policy.executor : default_executor());
+
+        // Sums the regular files of one directory and hands each subdirectory to the group as a new task
+        const auto scan = [&](const auto& self, const fs::path& directory) -> void {
+            uint64_t size = 0;
+            try {
+                for (const auto& entry : fs::directory_iterator(directory)) {
+                    try {
+                        if (entry.is_directory() && !entry.is_symlink())
+                            group.run([&self, subdirectory = entry.path()] { self(self, subdirectory); });
+                        else if (entry.is_regular_file())
+                            size += entry.file_size();
+                    } catch (const fs::filesystem_error& ex) {
+                        // Handle error while processing the current entry
+                        detail::report_diagnostic(diagnostic_kind::entry_error, entry.path().string(), ex.what());
+                    }
+                }
+            } catch (const fs::filesystem_error& ex) {
+                // Handle error while iterating over directory
+                detail::report_diagnostic(diagnostic_kind::directory_error, directory.string(), ex.what());
+            }
+            total.fetch_add(size, std::memory_order_relaxed);
+        };
+
+        scan(scan, path);
+        group.wait();
+        return total.load(std::memory_order_relaxed);
+    }
+    
+    // Storage - Content-defined chunk store
+    //****************************************************************
+    namespace detail {
+
+        // Incremental SHA-256 (FIPS 180-4)
+        class sha256 {
+        public:
+            void update(const std::uint8_t* data, std::size_t size) noexcept {
+                length_ += size;
+                if (used_) {
+                    const std::size_t count = std::min(size, block_.size() - used_);
+                    std::memcpy(block_.data() + used_, data, count);
+                    used_ += count;
+                    data += count;
+                    size -= count;
+                    if (used_ < block_.size())
+                        return;
+                    compress(block_.data());
+                    used_ = 0;
+                }
+                for (; size >= block_.size(); data += block_.size(), size -= block_.size())
+                    compress(data);
+                if (size)
+                    std::memcpy(block_.data(), data, size);
+                used_ = size;
+            }
+
+            std::array<std::uint8_t, 32> finish() noexcept {
+                const std::uint64_t bits = length_ * 8;
+                block_[used_++] = 0x80;
+                if (used_ > 56) {
+                    std::memset(block_.data() + used_, 0, block_.size() - used_);
+                    compress(block_.data());
+                    used_ = 0;
+                }
+                std::memset(block_.data() + used_, 0, 56 - used_);
+                for (int i = 0; i < 8; ++i)
+                    block_[63 - i] = static_cast<std::uint8_t>(bits >> (8 * i));
+                compress(block_.data());
+
+                std::array<std::uint8_t, 32> digest;
+                for (std::size_t i = 0; i < 8; ++i)
+                    for (std::size_t j = 0; j < 4; ++j)
+                        digest[4 * i + j] = static_cast<std::uint8_t>(state_[i] >> (24 - 8 * j));
+                return digest;
+            }
+
+        private:
+            void compress(const std::uint8_t* block) noexcept {
+                static constexpr std::uint32_t k[64] = {
+                    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+                    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+                    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+                    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+                    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+                    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+                    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+                    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+                };
+                std::uint32_t w[64];
+                for (std::size_t i = 0; i < 16; ++i)
+                    w[i] = std::uint32_t{ block[4 * i] } << 24 | std::uint32_t{ block[4 * i + 1] } << 16
+                         | std::uint32_t{ block[4 * i + 2] } << 8 | std::uint32_t{ block[4 * i + 3] };
+                for (std::size_t i = 16; i < 64; ++i) {
+                    const std::uint32_t s0 = std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                    const std::uint32_t s1 = std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                }
+
+                std::uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+                std::uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+                for (std::size_t i = 0; i < 64; ++i) {
+                    const std::uint32_t t1 = h + (std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+                    const std::uint32_t t2 = (std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                    h = g;
+                    g = f;
+                    f = e;
+                    e = d + t1;
+                    d = c;
+                    c = b;
+                    b = a;
+                    a = t1 + t2;
+                }
+                state_[0] += a;
+                state_[1] += b;
+                state_[2] += c;
+                state_[3] += d;
+                state_[4] += e;
+                state_[5] += f;
+                state_[6] += g;
+                state_[7] += h;
+            }
+
+            std::array<std::uint32_t, 8> state_ = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+            std::array<std::uint8_t, 64> block_{};
+            std::size_t used_ = 0;
+            std::uint64_t length_ = 0;
+        };
+
+        // Random 64-bit values for the gear rolling hash, one per byte value (splitmix64 sequence)
+        inline constexpr auto gear_table = [] {
+            std::array<std::uint64_t, 256> table{};
+            std::uint64_t state = 0x6b6f6e636172ULL;
+            for (auto& value : table) {
+                std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                value = z ^ (z >> 31);
+            }
+            return table;
+        }();
+
+    }
+
+    /**
+     * @brief Chunk size limits for koncar::content_chunker.
+     *
+     * @param min_size No boundary is placed before a chunk has this many bytes.
+     * @param average_size Expected chunk size, a power of two.
+     * @param max_size A chunk is cut at this size even without a content-defined boundary.
+     */
+    struct chunking_options {
+        std::size_t min_size = std::size_t{ 2 } << 10;
+        std::size_t average_size = std::size_t{ 8 } << 10;
+        std::size_t max_size = std::size_t{ 64 } << 10;
+    };
+
+    /**
+     * @brief Splits a byte stream into content-defined chunks with a gear rolling hash.
+     *
+     * A boundary is placed after a byte where the top bits of the rolling hash are zero, so an insertion or deletion
+     * only moves the boundaries near it and the chunks elsewhere stay identical. The hash depends on the last 64 bytes.
+     * Below the average size a stricter mask is used and above it a looser one (normalized chunking), which keeps
+     * chunk sizes close to the average.
+     *
+     * @details The stream is fed in pieces of any size. Chunks which lie entirely within one piece are passed on without
+     * being copied; only a chunk which spans pieces is collected in an internal buffer of at most `max_size` bytes.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::content_chunker chunker;
+     * while (const auto block = read_next_block())
+     *     chunker.feed(*block, [](std::span<const std::uint8_t> chunk) { store(chunk); });
+     * chunker.finish([](std::span<const std::uint8_t> chunk) { store(chunk); });
+     * \endcode
+     */
+    class content_chunker {
+    public:
+        explicit content_chunker(const chunking_options& options = {}) : options_(options) {
+            if (!std::has_single_bit(options.average_size) || options.average_size < 64 || options.min_size > options.average_size
+                || options.average_size > options.max_size)
+                throw std::invalid_argument("Chunk sizes must satisfy min <= average <= max with a power of two average of at least 64");
+            const int bits = std::countr_zero(options.average_size);
+            strict_mask_ = ~std::uint64_t{ 0 } << (63 - bits);
+            loose_mask_ = ~std::uint64_t{ 0 } << (65 - bits);
+            buffer_.reserve(options.max_size);
+        }
+
+        /**
+         * @brief Feeds the next bytes of the stream and calls `chunk(std::span<const std::uint8_t>)` for every chunk they complete.
+         */
+        template <typename Function>
+        void feed(std::span<const std::uint8_t> data, Function&& chunk) {
+            while (!data.empty()) {
+                const std::size_t cut = find_boundary(data, buffer_.size());
+                if (cut == npos) {
+                    buffer_.insert(buffer_.end(), data.begin(), data.end());
+                    return;
+                }
+                if (buffer_.empty()) {
+                    chunk(data.first(cut));
+                } else {
+                    buffer_.insert(buffer_.end(), data.begin(), data.begin() + static_cast<std::ptrdiff_t>(cut));
+                    chunk(std::span<const std::uint8_t>(buffer_));
+                    buffer_.clear();
+                }
+                data = data.subspan(cut);
+                hash_ = 0;
+            }
+        }
+
+        /**
+         * @brief Ends the stream, passing the last, possibly short, chunk to `chunk`. The chunker can then be reused.
+         */
+        template <typename Function>
+        void finish(Function&& chunk) {
+            if (!buffer_.empty())
+                chunk(std::span<const std::uint8_t>(buffer_));
+            buffer_.clear();
+            hash_ = 0;
+        }
+
+    private:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        // Number of bytes of `data` which complete the current chunk, whose first `consumed` bytes were seen before, or npos
+        std::size_t find_boundary(const std::span<const std::uint8_t> data, std::size_t consumed) noexcept {
+            std::size_t i = 0;
+            if (consumed < options_.min_size) {
+                i = std::min(options_.min_size - consumed, data.size());
+                consumed += i;
+            }
+            for (; i < data.size(); ++i, ++consumed) {
+                if (consumed == options_.max_size)
+                    return i;
+                hash_ = (hash_ << 1) + detail::gear_table[data[i]];
+                if (!(hash_ & (consumed < options_.average_size ? strict_mask_ : loose_mask_)))
+                    return i + 1;
+            }
+            return consumed == options_.max_size ? i : npos;
+        }
+
+        chunking_options options_;
+        std::uint64_t strict_mask_;
+        std::uint64_t loose_mask_;
+        std::uint64_t hash_ = 0;
+        std::vector<std::uint8_t> buffer_;
+    };
+
+    /**
+     * @brief Counters of a koncar::chunk_store, for the whole store or for one call of `add_tree`.
+     *
+     * `bytes` and `chunks` count all content added; `unique_bytes` and `unique_chunks` count the chunks which were
+     * not in the store yet, which is what storing the content actually costs.
+     */
+    struct chunk_store_stats {
+        std::uint64_t files = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t chunks = 0;
+        std::uint64_t unique_chunks = 0;
+        std::uint64_t unique_bytes = 0;
+
+        // Bytes added per byte stored; 1 when nothing was deduplicated
+        double dedup_ratio() const noexcept {
+            return unique_bytes ? static_cast<double>(bytes) / static_cast<double>(unique_bytes) : 1.0;
+        }
+    };
+
+    /**
+     * @brief Content-addressable store which keeps every distinct chunk of the added files once.
+     *
+     * Files are streamed through a koncar::content_chunker in fixed-size blocks, never loaded whole. Every chunk is
+     * named by the lower-case hexadecimal SHA-256 digest of its content and, if the store has a directory, written to
+     * `directory/<first two digits>/<digest>` the first time it is seen. Without a directory only the index is kept,
+     * which is enough to measure how much a tree would deduplicate. Chunks already in the directory are indexed when
+     * the store is opened, so deduplication carries over between runs.
+     *
+     * @details `add_tree` scans directories and chunks files in parallel on the policy's koncar::executor, one task per
+     * directory and per file; the store may also be used from several threads directly. Errors of individual files
+     * or directories in `add_tree` are reported to koncar::default_diagnostics() and the file is skipped, while
+     * `add_file` throws std::filesystem::filesystem_error.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::chunk_store store; // in-memory index only
+     * const koncar::chunk_store_stats stats = store.add_tree("Path\\ToDirectory", koncar::execution::par);
+     * // stats.unique_bytes is what a backup of the tree would store, stats.dedup_ratio() the space saved by deduplication
+     * \endcode
+     */
+    class chunk_store {
+    public:
+        // Lower-case hexadecimal SHA-256 digest of a chunk
+        using digest = std::string;
+
+        explicit chunk_store(fs::path directory = {}, const chunking_options& options = {})
+            : directory_(std::move(directory)), options_(options) {
+            content_chunker{ options_ }; // validates the options
+            if (directory_.empty())
+                return;
+            fs::create_directories(directory_);
+            for (const auto& entry : fs::recursive_directory_iterator(directory_)) {
+                const std::string name = entry.path().filename().string();
+                if (entry.is_regular_file() && is_digest(name))
+                    insert_key(name);
+            }
+        }
+
+        chunk_store(const chunk_store&) = delete;
+        chunk_store& operator=(const chunk_store&) = delete;
+
+        /**
+         * @brief Adds one file and returns the digests of its chunks in order, which is what is needed to restore it.
+         */
+        std::vector<digest> add_file(const fs::path& file) {
+            std::vector<digest> digests;
+            add_stream(file, totals_, &digests);
+            return digests;
+        }
+
+        /**
+         * @brief Adds every regular file below `root` and returns the counters of this call.
+         */
+        chunk_store_stats add_tree(const fs::path& root, const execution::parallel_policy& policy = {}) {
+            counters tree;
+            task_group group(policy.executor ? *policy.executor : default_executor());
+
+            const auto add = [&](const fs::path& file) {
+                try {
+                    add_stream(file, tree, nullptr);
+                } catch (const std::exception& ex) {
+                    detail::report_diagnostic(diagnostic_kind::entry_error, file.string(), ex.what());
+                }
+            };
+            // Hands each file and each subdirectory of one directory to the group as a new task
+            const auto scan = [&](const auto& self, const fs::path& directory) -> void {
+                try {
+                    for (const auto& entry : fs::directory_iterator(directory)) {
+                        try {
+                            if (entry.is_directory() && !entry.is_symlink())
+                                group.run([&self, subdirectory = entry.path()] { self(self, subdirectory); });
+                            else if (entry.is_regular_file())
+                                group.run([&add, file = entry.path()] { add(file); });
+                        } catch (const fs::filesystem_error& ex) {
+                            detail::report_diagnostic(diagnostic_kind::entry_error, entry.path().string(), ex.what());
+                        }
+                    }
+                } catch (const fs::filesystem_error& ex) {
+                    detail::report_diagnostic(diagnostic_kind::directory_error, directory.string(), ex.what());
+                }
+            };
+
+            if (fs::is_regular_file(root))
+                add(root);
+            else
+                scan(scan, root);
+            group.wait();
+            tree.add_to(totals_);
+            return tree.snapshot();
+        }
+
+        // Whether a chunk with this digest is in the store; false for anything which is not 64 hexadecimal digits
+        bool contains(const std::string_view chunk_digest) const {
+            if (!is_digest(chunk_digest))
+                return false;
+            const shard& target = shard_of(chunk_digest);
+            std::lock_guard lock(target.mutex);
+            return target.keys.contains(std::string(chunk_digest));
+        }
+
+        // Where the chunk with this digest is (or would be) stored; throws std::invalid_argument for a malformed digest
+        fs::path chunk_path(const std::string_view chunk_digest) const {
+            if (!is_digest(chunk_digest))
+                throw std::invalid_argument("chunk_store: '" + std::string(chunk_digest) + "' is not a 64-digit hexadecimal digest");
+            return directory_ / std::string(chunk_digest.substr(0, 2)) / std::string(chunk_digest);
+        }
+
+        // Counters of everything added to this store object
+        chunk_store_stats stats() const noexcept { return totals_.snapshot(); }
+
+    private:
+        struct counters {
+            std::atomic<std::uint64_t> files{ 0 };
+            std::atomic<std::uint64_t> bytes{ 0 };
+            std::atomic<std::uint64_t> chunks{ 0 };
+            std::atomic<std::uint64_t> unique_chunks{ 0 };
+            std::atomic<std::uint64_t> unique_bytes{ 0 };
+
+            chunk_store_stats snapshot() const noexcept {
+                return { files.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed), chunks.load(std::memory_order_relaxed),
+                         unique_chunks.load(std::memory_order_relaxed), unique_bytes.load(std::memory_order_relaxed) };
+            }
+
+            void add_to(counters& other) const noexcept {
+                const chunk_store_stats values = snapshot();
+                other.files.fetch_add(values.files, std::memory_order_relaxed);
+                other.bytes.fetch_add(values.bytes, std::memory_order_relaxed);
+                other.chunks.fetch_add(values.chunks, std::memory_order_relaxed);
+                other.unique_chunks.fetch_add(values.unique_chunks, std::memory_order_relaxed);
+                other.unique_bytes.fetch_add(values.unique_bytes, std::memory_order_relaxed);
+            }
+        };
+
+        // The index is split by the first digest byte so that concurrent inserts rarely contend
+        struct alignas(64) shard {
+            mutable std::mutex mutex;
+            std::unordered_set<std::string> keys;
+        };
+
+        static constexpr std::size_t block_size = std::size_t{ 1 } << 20;
+
+        static bool is_digest(const std::string_view text) noexcept {
+            return text.size() == 64 && std::all_of(text.begin(), text.end(), [](const char c) { return detail::hex_values[static_cast<unsigned char>(c)] < 16; });
+        }
+
+        // Only for well-formed digests (see is_digest)
+        shard& shard_of(const std::string_view chunk_digest) noexcept {
+            return shards_[static_cast<std::size_t>(detail::hex_values[static_cast<unsigned char>(chunk_digest[0])] << 4 | detail::hex_values[static_cast<unsigned char>(chunk_digest[1])])];
+        }
+
+        const shard& shard_of(const std::string_view chunk_digest) const noexcept {
+            return const_cast<chunk_store*>(this)->shard_of(chunk_digest);
+        }
+
+        bool insert_key(const std::string& key) {
+            shard& target = shard_of(key);
+            std::lock_guard lock(target.mutex);
+            return target.keys.insert(key).second;
+        }
+
+        void erase_key(const std::string& key) {
+            shard& target = shard_of(key);
+            std::lock_guard lock(target.mutex);
+            target.keys.erase(key);
+        }
+
+        void add_stream(const fs::path& file, counters& into, std::vector<digest>* digests) {
+            std::ifstream stream(file, std::ios::binary);
+            if (!stream)
+                throw fs::filesystem_error("Cannot open file", file, std::make_error_code(std::errc::io_error));
+
+            content_chunker chunker(options_);
+            std::vector<std::uint8_t> block(block_size);
+            std::uint64_t bytes = 0, chunks = 0, unique_chunks = 0, unique_bytes = 0;
+            const auto store = [&](const std::span<const std::uint8_t> chunk) {
+                detail::sha256 hash;
+                hash.update(chunk.data(), chunk.size());
+                const std::array<std::uint8_t, 32> sum = hash.finish();
+                digest key(64, '\0');
+                detail::encode_hex(sum.data(), sum.size(), key.data(), false);
+
+                ++chunks;
+                bytes += chunk.size();
+                if (insert_key(key)) {
+                    if (!directory_.empty())
+                        write_chunk(key, chunk);
+                    ++unique_chunks;
+                    unique_bytes += chunk.size();
+                }
+                if (digests)
+                    digests->push_back(std::move(key));
+            };
+
+            while (stream) {
+                stream.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(block.size()));
+                const auto count = static_cast<std::size_t>(stream.gcount());
+                if (count == 0)
+                    break;
+                chunker.feed(std::span<const std::uint8_t>(block.data(), count), store);
+            }
+            if (stream.bad())
+                throw fs::filesystem_error("Cannot read file", file, std::make_error_code(std::errc::io_error));
+            chunker.finish(store);
+
+            into.files.fetch_add(1, std::memory_order_relaxed);
+            into.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            into.chunks.fetch_add(chunks, std::memory_order_relaxed);
+            into.unique_chunks.fetch_add(unique_chunks, std::memory_order_relaxed);
+            into.unique_bytes.fetch_add(unique_bytes, std::memory_order_relaxed);
+        }
+
+        // Writes a new chunk through a temporary file, so a chunk file is either complete or absent
+        void write_chunk(const std::string& key, const std::span<const std::uint8_t> chunk) {
+            try {
+                const fs::path target = chunk_path(key);
+                fs::create_directories(target.parent_path());
+                fs::path temporary = target;
+                temporary += ".tmp";
+                {
+                    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+                    out.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+                    if (!out.flush())
+                        throw fs::filesystem_error("Cannot write chunk", temporary, std::make_error_code(std::errc::io_error));
+                }
+                fs::rename(temporary, target);
+            } catch (...) {
+                // The chunk is not stored, so a later occurrence has to write it
+                erase_key(key);
+                throw;
+            }
+        }
+
+        fs::path directory_;
+        chunking_options options_;
+        std::array<shard, 256> shards_;
+        counters totals_;
+    };
+
+    // Tuning - Host calibration
+    //****************************************************************
+    /**
+     * @brief Machine-dependent choices of the library: hex kernel, parallel hex thresholds and traversal threads.
+     *
+     * A default-constructed tuning holds the built-in defaults, which is what koncar uses without a calibration.
+     *
+     * @param kernel Name of the hexadecimal kernel to use, one of koncar::hex_kernels(); empty keeps the default choice.
+     * @param encode_threshold Bytes below which hexadecimal encoding stays on the calling thread; SIZE_MAX if threads never paid off.
+     * @param encode_grain Minimum number of bytes handed to one thread when encoding.
+     * @param decode_threshold Bytes of binary output below which hexadecimal decoding stays on the calling thread.
+     * @param decode_grain Minimum number of bytes of binary output handed to one thread when decoding.
+     * @param traversal_threads Workers of the executor which traverses directory trees fastest; 0 keeps koncar::default_executor().
+     */
+    struct tuning {
+        std::string kernel;
+        std::size_t encode_threshold = execution::parallel_policy{}.threshold;
+        std::size_t encode_grain = execution::parallel_policy{}.grain;
+        std::size_t decode_threshold = execution::parallel_policy{}.threshold;
+        std::size_t decode_grain = execution::parallel_policy{}.grain;
+        unsigned traversal_threads = 0;
+
+        // Policy for hexadecimal encoding with the calibrated threshold and grain
+        execution::parallel_policy encode_policy() const noexcept {
+            execution::parallel_policy policy;
+            policy.threshold = encode_threshold;
+            policy.grain = encode_grain;
+            return policy;
+        }
+
+        // Policy for hexadecimal decoding with the calibrated threshold and grain
+        execution::parallel_policy decode_policy() const noexcept {
+            execution::parallel_policy policy;
+            policy.threshold = decode_threshold;
+            policy.grain = decode_grain;
+            return policy;
+        }
+    };
+
+    namespace detail {
+
+        // Processor brand string, e.g. "Intel(R) Xeon(R) Gold 6338 CPU @ 2.00GHz", or "unknown"
+        inline std::string cpu_model() {
+            std::string model;
+#ifdef KONCAR_X86_KERNELS
+            if (__get_cpuid_max(0x80000000, nullptr) >= 0x80000004) {
+                unsigned registers[12];
+                for (unsigned leaf = 0; leaf < 3; ++leaf)
+                    __get_cpuid(0x80000002 + leaf, &registers[4 * leaf], &registers[4 * leaf + 1], &registers[4 * leaf + 2], &registers[4 * leaf + 3]);
+                model.assign(reinterpret_cast<const char*>(registers), sizeof registers);
+                if (const std::size_t end = model.find('\0'); end != std::string::npos)
+                    model.erase(end);
+            }
+#elif defined(__linux__)
+            std::ifstream cpuinfo("/proc/cpuinfo");
+            for (std::string line; model.empty() && std::getline(cpuinfo, line);) {
+                if (line.starts_with("model name") || line.starts_with("Processor") || line.starts_with("CPU part"))
+                    model = line.substr(line.find(':') == std::string::npos ? line.size() : line.find(':') + 1);
+            }
+#endif
+            const std::size_t first = model.find_first_not_of(' ');
+            if (first == std::string::npos)
+                return "unknown";
+            model.erase(0, first);
+            model.erase(model.find_last_not_of(' ') + 1);
+            return model;
+        }
+
+        // Fastest of `runs` runs of `function`, in seconds
+        template <typename Function>
+        double best_time(const int runs, Function&& function) {
+            double best = std::numeric_limits<double>::max();
+            for (int run = 0; run < runs; ++run) {
+                const auto start = std::chrono::steady_clock::now();
+                function();
+                best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+            return best;
+        }
+
+        // The kernel with the fastest encode and decode of 64 KiB, which stays in the L2 cache
+        inline const hex_kernel& calibrate_hex_kernel() {
+            std::vector<std::uint8_t> bytes(std::size_t{ 1 } << 16);
+            std::uint64_t state = 0x9E3779B97F4A7C15;
+            for (auto& byte : bytes) {
+                state = state * 6364136223846793005 + 1442695040888963407;
+                byte = static_cast<std::uint8_t>(state >> 56);
+            }
+            std::vector<char> text(2 * bytes.size());
+
+            const hex_kernel* best = nullptr;
+            double best_seconds = 0;
+            for (const hex_kernel& kernel : hex_kernels()) {
+                const double seconds = best_time(7, [&] {
+                    for (int repeat = 0; repeat < 4; ++repeat) {
+                        kernel.encode(bytes.data(), bytes.size(), text.data(), true);
+                        kernel.decode(text.data(), text.size(), bytes.data());
+                    }
+                });
+                if (!best || seconds < best_seconds) {
+                    best = &kernel;
+                    best_seconds = seconds;
+                }
+            }
+            return *best;
+        }
+
+        // Smallest size from 4 KiB to `largest` bytes from which on running `code(first, last)` in parallel slices beats
+        // the calling thread alone, with the grain to use from there on; SIZE_MAX if threads never win
+        template <typename Code>
+        std::pair<std::size_t, std::size_t> calibrate_parallel_threshold(const std::size_t largest, Code&& code) {
+            executor& pool = default_executor();
+            const std::size_t tasks = pool.concurrency() + (pool.owns_current_thread() ? 0 : 1);
+            for (std::size_t size = std::size_t{ 1 } << 12; size <= largest; size <<= 2) {
+                const double sequential = best_time(5, [&] { code(std::size_t{ 0 }, size); });
+                execution::parallel_policy policy;
+                policy.threshold = 0;
+                policy.grain = std::max<std::size_t>(size / tasks, std::size_t{ 1 } << 11);
+                const double parallel = best_time(5, [&] { parallel_slices(size, policy, code); });
+                // Threads have to win clearly, timings this short are noisy
+                if (parallel < 0.8 * sequential)
+                    return { size, size / 2 };
+            }
+            return { std::numeric_limits<std::size_t>::max(), execution::parallel_policy{}.grain };
+        }
+
+        // Encoding and decoding thresholds of `kernel` for binary sizes up to 16 MiB; the two directions differ in cost
+        inline void calibrate_hex_thresholds(const hex_kernel& kernel, tuning& result) {
+            constexpr std::size_t largest = std::size_t{ 1 } << 24;
+            const auto bytes = std::make_unique_for_overwrite<std::uint8_t[]>(largest);
+            const auto text = std::make_unique_for_overwrite<char[]>(2 * largest);
+            // Touch both buffers first, so page faults do not count against the first run of a size
+            std::memset(bytes.get(), 0xA5, largest);
+            std::memset(text.get(), '0', 2 * largest);
+
+            std::tie(result.encode_threshold, result.encode_grain) = calibrate_parallel_threshold(largest, [&](const std::size_t first, const std::size_t last) {
+                kernel.encode(bytes.get() + first, last - first, text.get() + 2 * first, true);
+            });
+            std::tie(result.decode_threshold, result.decode_grain) = calibrate_parallel_threshold(largest, [&](const std::size_t first, const std::size_t last) {
+                kernel.decode(text.get() + 2 * first, 2 * (last - first), bytes.get() + first);
+            });
+        }
+
+        // Executor size which sums a temporary tree of 128 directories and 1024 files fastest
+        inline unsigned calibrate_traversal_threads() {
+            const unsigned cpus = static_cast<unsigned>(cpu_topology::get().cpus.size());
+            std::error_code error;
+            const fs::path root = fs::temp_directory_path(error) /
+                str_concat("koncar-tune-", std::chrono::steady_clock::now().time_since_epoch().count());
+            if (error)
+                return cpus;
+
+            unsigned best = cpus;
+            try {
+                for (int outer = 0; outer < 16; ++outer) {
+                    for (int inner = 0; inner < 8; ++inner) {
+                        const fs::path directory = root / std::to_string(outer) / std::to_string(inner);
+                        fs::create_directories(directory);
+                        for (int file = 0; file < 8; ++file)
+                            std::ofstream(directory / std::to_string(file)) << file;
+                    }
+                }
+
+                // More threads than CPUs can still help, since traversal blocks in system calls
+                double best_seconds = std::numeric_limits<double>::max();
+                for (unsigned threads = 1; threads <= 2 * cpus; threads = threads < cpus && 2 * threads > cpus ? cpus : 2 * threads) {
+                    executor pool({ .threads = threads });
+                    execution::parallel_policy policy;
+                    policy.executor = &pool;
+                    const double seconds = best_time(3, [&] { directory_size(root, policy); });
+                    // A larger pool has to be clearly faster to be worth its threads
+                    if (seconds < 0.9 * best_seconds) {
+                        best = threads;
+                        best_seconds = seconds;
+                    }
+                }
+            } catch (const std::exception&) {
+                // The tree could not be created; keep one worker per CPU
+            }
+            fs::remove_all(root, error);
+            return best;
+        }
+
+        // Cache entry of the tuning, with the host it was measured on
+        inline constexpr std::string_view tuning_format = "koncar-tuning 2";
+
+        inline std::optional<tuning> read_tuning(const fs::path& file, const std::string& cpu, const std::size_t cpus) {
+            std::ifstream in(file);
+            std::string line;
+            if (!std::getline(in, line) || line != tuning_format)
+                return std::nullopt;
+
+            tuning result;
+            bool same_host = false;
+            bool same_cpus = false;
+            const auto number = [](const std::string_view text, auto& value) {
+                const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+                return error == std::errc() && end == text.data() + text.size();
+            };
+            while (std::getline(in, line)) {
+                const std::size_t space = line.find(' ');
+                if (space == std::string::npos)
+                    return std::nullopt;
+                const std::string_view name = std::string_view(line).substr(0, space);
+                const std::string_view value = std::string_view(line).substr(space + 1);
+                std::size_t count = 0;
+                bool valid = true;
+                if (name == "cpu")
+                    same_host = value == cpu;
+                else if (name == "cpus")
+                    same_cpus = number(value, count) && count == cpus;
+                else if (name == "kernel")
+                    result.kernel = value;
+                else if (name == "encode_threshold")
+                    valid = number(value, result.encode_threshold);
+                else if (name == "encode_grain")
+                    valid = number(value, result.encode_grain);
+                else if (name == "decode_threshold")
+                    valid = number(value, result.decode_threshold);
+                else if (name == "decode_grain")
+                    valid = number(value, result.decode_grain);
+                else if (name == "traversal_threads")
+                    valid = number(value, result.traversal_threads);
+                if (!valid)
+                    return std::nullopt;
+            }
+            // Another model or CPU count, e.g. a home directory shared across a heterogeneous fleet, needs its own tuning
+            if (!same_host || !same_cpus || result.encode_grain == 0 || result.decode_grain == 0 || result.traversal_threads == 0 ||
+                std::ranges::none_of(hex_kernels(), [&](const hex_kernel& kernel) { return kernel.name == result.kernel; }))
+                return std::nullopt;
+            return result;
+        }
+
+        // Writes through a temporary file, so concurrent processes never read a partial entry
+        inline void write_tuning(const fs::path& file, const tuning& result, const std::string& cpu, const std::size_t cpus) {
+            std::error_code error;
+            fs::create_directories(file.parent_path(), error);
+            fs::path temporary = file;
+            temporary += str_concat(".", std::chrono::steady_clock::now().time_since_epoch().count(), ".tmp");
+            {
+                std::ofstream out(temporary, std::ios::trunc);
+                out << tuning_format << "\ncpu " << cpu << "\ncpus " << cpus << "\nkernel " << result.kernel
+                    << "\nencode_threshold " << result.encode_threshold << "\nencode_grain " << result.encode_grain
+                    << "\ndecode_threshold " << result.decode_threshold << "\ndecode_grain " << result.decode_grain
+                    << "\ntraversal_threads " << result.traversal_threads << '\n';
+                if (!out.flush()) {
+                    out.close();
+                    fs::remove(temporary, error);
+                    return;
+                }
+            }
+            fs::rename(temporary, file, error);
+            if (error)
+                fs::remove(temporary, error);
+        }
+
+    }
+
+    /**
+     * @brief Measures the best tuning for this host with short micro-benchmarks (a fraction of a second to a few seconds).
+     *
+     * Every supported hex kernel encodes and decodes 64 KiB; the fastest is chosen. The chosen kernel then encodes,
+     * and separately decodes, inputs from 4 KiB to 16 MiB on the calling thread and on koncar::default_executor();
+     * each threshold is the first size at which the threads are clearly faster. This allocates and touches 48 MiB.
+     * Directory trees are traversed with executors of 1 to 2 * CPUs workers over a temporary tree of 1024 files,
+     * created and removed in the temporary directory. That tree is small and hot in the page cache, so the thread count
+     * favours cached metadata and is only a starting point for cold trees. Nothing is changed or cached, see
+     * koncar::auto_tune for that.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * const koncar::tuning measured = koncar::calibrate();
+     * const std::string hex_string = koncar::binary_to_string(measured.encode_policy(), firmware_image);
+     * \endcode
+     */
+    inline tuning calibrate() {
+        tuning result;
+        const hex_kernel& kernel = detail::calibrate_hex_kernel();
+        result.kernel = kernel.name;
+        detail::calibrate_hex_thresholds(kernel, result);
+        result.traversal_threads = detail::calibrate_traversal_threads();
+        return result;
+    }
+
+    /**
+     * @brief Path of the tuning cache of this host: `$XDG_CACHE_HOME/koncar/tuning-<hash of the CPU model>`,
+     * or `$HOME/.cache/koncar/...` without XDG_CACHE_HOME. Empty if neither variable is set.
+     */
+    inline fs::path tuning_cache_file() {
+        fs::path directory;
+        if (const char* cache = std::getenv("XDG_CACHE_HOME"); cache && *cache)
+            directory = cache;
+        else if (const char* home = std::getenv("HOME"); home && *home)
+            directory = fs::path(home) / ".cache";
+        else
+            return {};
+
+        // FNV-1a of the model, so every model of a shared cache directory has its own file
+        std::uint64_t hash = 0xCBF29CE484222325;
+        for (const char c : detail::cpu_model())
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3;
+        char name[32];
+        std::snprintf(name, sizeof name, "tuning-%016llx", static_cast<unsigned long long>(hash));
+        return directory / "koncar" / name;
+    }
+
+    /**
+     * @brief Applies the cached tuning of this host once and returns the tuning in effect.
+     *
+     * The first call reads the tuning cached by an earlier calibration on the same CPU model and CPU count
+     * (see koncar::tuning_cache_file) and selects its kernel with koncar::select_hex_kernel. Without a usable cache
+     * entry it returns the built-in defaults, a default-constructed koncar::tuning, and measures nothing: calibration
+     * allocates tens of MiB and writes a temporary tree, which no ordinary call should pay for. Only `recalibrate`
+     * runs koncar::calibrate, replaces the cache entry and applies the new tuning. Later calls return a copy of the
+     * same tuning without any work. The tuning is returned by value so that a concurrent recalibration cannot change
+     * it under the caller. Thresholds and thread counts are not applied implicitly: pass `encode_policy()`,
+     * `decode_policy()` and an executor of `traversal_threads` workers to the operations which should use them.
+     *
+     * Example usage:
+     * \code{.cpp}
+     * koncar::auto_tune(true); // once, e.g. from an installer or `koncar tune`
+     * // later, in any process on this host
+     * const koncar::tuning tuned = koncar::auto_tune();
+     * const std::string hex_string = koncar::binary_to_string(tuned.encode_policy(), firmware_image);
+     * \endcode
+     */
+    inline tuning auto_tune(const bool recalibrate = false) {
+        static std::mutex mutex;
+        static std::optional<tuning> current;
+
+        std::lock_guard lock(mutex);
+        if (current && !recalibrate)
+            return *current;
+
+        const std::string cpu = detail::cpu_model();
+        const std::size_t cpus = detail::cpu_topology::get().cpus.size();
+        const fs::path file = tuning_cache_file();
+        std::optional<tuning> cached;
+        if (!recalibrate && !file.empty())
+            cached = detail::read_tuning(file, cpu, cpus);
+        if (cached) {
+            current = std::move(cached);
+        } else if (recalibrate) {
+            current = calibrate();
+            if (!file.empty())
+                detail::write_tuning(file, *current, cpu, cpus);
+        } else {
+            current = tuning{};
+        }
+        if (!current->kernel.empty())
+            select_hex_kernel(current->kernel);
+        return *current;
+    }
+
 }
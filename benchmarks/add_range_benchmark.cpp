@@ -0,0 +1,262 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Licence information: Copyright Filip Matjašec©
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Benchmark of koncar::add_range against hand-written append patterns.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++20 -O2 -DNDEBUG benchmarks/add_range_benchmark.cpp -o add_range_benchmark
+//   ./add_range_benchmark [--quick] [filter]
+//
+// Every row appends N elements of one element type to one destination type, using one append pattern,
+// with or without reserving the destination first. Reported per appended element:
+//   ns/elem     wall time of the append only (building the source and destroying the destination are excluded)
+//   allocs      heap allocations (global operator new calls)
+//   bytes       heap bytes requested
+//   copied      bytes copied or moved by element constructors and assignments, including reallocation
+//               (instrumented element types only, "-" for trivially copyable types)
+
+#include "../Koncar_assignment.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+
+namespace {
+
+    // Allocation counters fed by the replaced global operator new
+    std::size_t allocation_count = 0;
+    std::size_t allocation_bytes = 0;
+
+    // Bytes copied or moved by the instrumented element types
+    std::size_t copied_bytes = 0;
+
+    struct counters {
+        std::size_t allocations;
+        std::size_t bytes;
+        std::size_t copied;
+
+        static counters now() { return { allocation_count, allocation_bytes, copied_bytes }; }
+    };
+
+    // Trivially copyable 32-byte record
+    struct trivial_record {
+        std::uint64_t id;
+        std::uint64_t timestamp;
+        double value;
+        std::uint32_t channel;
+        std::uint32_t flags;
+    };
+
+    // Move-only element owning one heap object
+    struct move_only {
+        std::unique_ptr<std::uint64_t> payload;
+
+        explicit move_only(const std::size_t i) : payload(std::make_unique<std::uint64_t>(i)) {}
+        move_only(move_only&& other) noexcept : payload(std::move(other.payload)) { copied_bytes += sizeof(move_only); }
+        move_only& operator=(move_only&& other) noexcept {
+            payload = std::move(other.payload);
+            copied_bytes += sizeof(move_only);
+            return *this;
+        }
+    };
+
+    // Copyable element owning a 64-character heap string
+    struct heavy {
+        std::string text;
+
+        explicit heavy(const std::size_t i) : text(64, static_cast<char>('a' + i % 26)) {}
+        heavy(const heavy& other) : text(other.text) { copied_bytes += sizeof(heavy) + text.size(); }
+        heavy(heavy&& other) noexcept : text(std::move(other.text)) { copied_bytes += sizeof(heavy); }
+        heavy& operator=(const heavy& other) {
+            text = other.text;
+            copied_bytes += sizeof(heavy) + text.size();
+            return *this;
+        }
+        heavy& operator=(heavy&& other) noexcept {
+            text = std::move(other.text);
+            copied_bytes += sizeof(heavy);
+            return *this;
+        }
+    };
+
+    template <typename T>
+    T make_value(const std::size_t i) {
+        if constexpr (std::is_same_v<T, char>)
+            return static_cast<char>('a' + i % 26);
+        else if constexpr (std::is_same_v<T, trivial_record>)
+            return { i, i * 3, static_cast<double>(i), static_cast<std::uint32_t>(i % 16), 0 };
+        else
+            return T(i);
+    }
+
+    template <typename T>
+    std::vector<T> make_source(const std::size_t count) {
+        std::vector<T> source;
+        source.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            source.push_back(make_value<T>(i));
+        return source;
+    }
+
+    template <typename T>
+    constexpr bool copyable = std::is_copy_constructible_v<T>;
+
+    template <typename T>
+    constexpr bool instrumented = std::is_same_v<T, move_only> || std::is_same_v<T, heavy>;
+
+    // One append pattern: receives the destination and a source it may consume
+    template <typename Destination, typename T>
+    struct pattern {
+        const char* name;
+        std::function<void(Destination&, std::vector<T>&)> append;
+    };
+
+    template <typename Destination, typename T>
+    std::vector<pattern<Destination, T>> patterns() {
+        std::vector<pattern<Destination, T>> result;
+
+        // The source is consumed (moved from) by every pattern, so move-only elements are covered as well
+        result.push_back({ "add_range(range)", [](Destination& d, std::vector<T>& s) { koncar::add_range(d, std::move(s)); } });
+        result.push_back({ "add_range(pack of 8)", [](Destination& d, std::vector<T>& s) {
+            for (std::size_t i = 0; i + 8 <= s.size(); i += 8)
+                koncar::add_range(d, std::move(s[i]), std::move(s[i + 1]), std::move(s[i + 2]), std::move(s[i + 3]),
+                                  std::move(s[i + 4]), std::move(s[i + 5]), std::move(s[i + 6]), std::move(s[i + 7]));
+        } });
+        result.push_back({ "push_back loop", [](Destination& d, std::vector<T>& s) {
+            for (auto& element : s)
+                d.push_back(std::move(element));
+        } });
+        result.push_back({ "pack of 8 push_back", [](Destination& d, std::vector<T>& s) {
+            for (std::size_t i = 0; i + 8 <= s.size(); i += 8)
+                for (std::size_t j = i; j < i + 8; ++j)
+                    d.push_back(std::move(s[j]));
+        } });
+        result.push_back({ "insert(end, first, last)", [](Destination& d, std::vector<T>& s) {
+            d.insert(d.end(), std::make_move_iterator(s.begin()), std::make_move_iterator(s.end()));
+        } });
+        if constexpr (copyable<T>) {
+            result.push_back({ "add_range(const range)", [](Destination& d, std::vector<T>& s) { koncar::add_range(d, std::as_const(s)); } });
+        }
+#ifdef __cpp_lib_containers_ranges
+        if constexpr (requires(Destination& d, std::vector<T>& s) { d.append_range(s); }) {
+            result.push_back({ "append_range", [](Destination& d, std::vector<T>& s) { d.append_range(std::move(s)); } });
+        }
+#endif
+        return result;
+    }
+
+    const char* filter = nullptr;
+    bool quick = false;
+
+    template <typename Destination, typename T>
+    void run(const char* destination_name, const char* element_name) {
+        const std::size_t sizes[] = { 8, 1024, std::size_t{ 1 } << 20 };
+
+        for (const std::size_t size : sizes) {
+            const std::size_t target_elements = quick ? (std::size_t{ 1 } << 20) : (std::size_t{ 1 } << 24);
+            const std::size_t repetitions = std::max<std::size_t>(1, target_elements / size);
+
+            for (const bool reserve : { false, true }) {
+                if (reserve && !koncar::detail::reservable<Destination>)
+                    continue;
+
+                for (const auto& p : patterns<Destination, T>()) {
+                    char label[160];
+                    std::snprintf(label, sizeof label, "%s <- %s", destination_name, element_name);
+                    if (filter && !std::strstr(label, filter) && !std::strstr(p.name, filter))
+                        continue;
+
+                    std::chrono::nanoseconds elapsed{ 0 };
+                    counters total{ 0, 0, 0 };
+                    for (std::size_t r = 0; r < repetitions; ++r) {
+                        std::vector<T> source = make_source<T>(size);
+                        Destination destination;
+                        if constexpr (koncar::detail::reservable<Destination>) {
+                            if (reserve)
+                                destination.reserve(size);
+                        }
+
+                        const counters before = counters::now();
+                        const auto start = std::chrono::steady_clock::now();
+                        p.append(destination, source);
+                        const auto stop = std::chrono::steady_clock::now();
+                        const counters after = counters::now();
+
+                        elapsed += stop - start;
+                        total.allocations += after.allocations - before.allocations;
+                        total.bytes += after.bytes - before.bytes;
+                        total.copied += after.copied - before.copied;
+                    }
+
+                    const double elements = static_cast<double>(size * repetitions);
+                    char copied[32] = "-";
+                    if constexpr (instrumented<T>)
+                        std::snprintf(copied, sizeof copied, "%.1f", total.copied / elements);
+                    std::printf("%-34s %8zu  %-8s %-26s %10.2f %10.4f %10.1f %10s\n", label, size, reserve ? "reserve" : "-",
+                                p.name, elapsed.count() / elements, total.allocations / elements, total.bytes / elements, copied);
+                }
+            }
+        }
+    }
+
+}
+
+// Count every heap allocation made by the benchmark. Both forms of operator new allocate with malloc/aligned_alloc,
+// so free releases them; GCC cannot see that through the replacement and warns about a mismatch.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void* operator new(const std::size_t size) {
+    ++allocation_count;
+    allocation_bytes += size;
+    if (void* pointer = std::malloc(size ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    ++allocation_count;
+    allocation_bytes += size;
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+#pragma GCC diagnostic pop
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--quick") == 0)
+            quick = true;
+        else
+            filter = argv[i];
+    }
+
+    std::printf("%-34s %8s  %-8s %-26s %10s %10s %10s %10s\n", "destination <- element", "N", "reserve", "pattern",
+                "ns/elem", "allocs", "bytes", "copied");
+
+    run<std::vector<trivial_record>, trivial_record>("vector", "trivial_record");
+    run<std::deque<trivial_record>, trivial_record>("deque", "trivial_record");
+    run<koncar::small_vector<trivial_record, 16>, trivial_record>("small_vector<16>", "trivial_record");
+
+    run<std::vector<move_only>, move_only>("vector", "move_only");
+    run<std::deque<move_only>, move_only>("deque", "move_only");
+    run<koncar::small_vector<move_only, 16>, move_only>("small_vector<16>", "move_only");
+
+    run<std::vector<heavy>, heavy>("vector", "heavy");
+    run<std::deque<heavy>, heavy>("deque", "heavy");
+    run<koncar::small_vector<heavy, 16>, heavy>("small_vector<16>", "heavy");
+
+    run<std::string, char>("string", "char");
+    run<std::vector<char>, char>("vector", "char");
+    return 0;
+}
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Licence information: Copyright Filip Matjašec©
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Tests of koncar::crc32c, koncar::xxhash64 and the checksummed hexadecimal conversions.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++20 -O2 tests/checksum_test.cpp -o checksum_test
+//   ./checksum_test
+//
+// Every check prints its name; the exit status is 0 when all of them pass.
+
+#include "../Koncar_assignment.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+
+namespace {
+
+    int failures = 0;
+
+    void check(const bool condition, const char* what) {
+        std::printf("%s %s\n", condition ? "ok  " : "FAIL", what);
+        if (!condition)
+            ++failures;
+    }
+
+    std::span<const std::uint8_t> bytes_of(const std::string_view text) {
+        return { reinterpret_cast<const std::uint8_t*>(text.data()), text.size() };
+    }
+
+    // Bit-at-a-time CRC-32C, the definition the table and hardware versions must agree with
+    std::uint32_t reference_crc32c(const std::uint8_t* data, const std::size_t size) {
+        std::uint32_t crc = 0xFFFFFFFF;
+        for (std::size_t i = 0; i < size; ++i) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit)
+                crc = crc & 1 ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+        }
+        return ~crc;
+    }
+
+    std::vector<std::uint8_t> random_bytes(std::mt19937& random, const std::size_t size) {
+        std::vector<std::uint8_t> data(size);
+        for (std::uint8_t& byte : data)
+            byte = static_cast<std::uint8_t>(random());
+        return data;
+    }
+
+    void crc32c_vectors() {
+        check(koncar::crc32c(bytes_of("123456789")) == 0xE3069283, "crc32c: check value of \"123456789\"");
+        check(koncar::crc32c({}) == 0, "crc32c: empty input");
+        const std::vector<std::uint8_t> zeros(32, 0), ones(32, 0xFF);
+        // RFC 3720, appendix B.4
+        check(koncar::crc32c(zeros) == 0x8A9136AA && koncar::crc32c(ones) == 0x62A8AB43, "crc32c: iSCSI test patterns");
+    }
+
+    void crc32c_random() {
+        std::mt19937 random(3);
+        // Sizes around the 3 x 1024-byte interleaved streams, the 8-byte words and the tail bytes
+        const std::vector<std::uint8_t> data = random_bytes(random, 20000);
+        bool same = true, same_scalar = true, continued = true;
+        for (int round = 0; round < 500; ++round) {
+            const std::size_t offset = random() % 64;
+            const std::size_t size = round < 100 ? static_cast<std::size_t>(round) : random() % (data.size() - offset);
+            const std::uint8_t* first = data.data() + offset;
+            const std::uint32_t expected = reference_crc32c(first, size);
+            same = same && koncar::crc32c({ first, size }) == expected;
+            same_scalar = same_scalar && ~koncar::detail::crc32c_update_scalar(0xFFFFFFFF, first, size) == expected;
+            const std::size_t split = size ? random() % size : 0;
+            continued = continued && koncar::crc32c({ first + split, size - split }, koncar::crc32c({ first, split })) == expected;
+        }
+        check(same, "crc32c: random sizes and offsets match the bitwise reference");
+        check(same_scalar, "crc32c: the table version matches the bitwise reference");
+        check(continued, "crc32c: continuing from the CRC of a prefix");
+    }
+
+    void xxhash64_vectors() {
+        check(koncar::xxhash64({}) == 0xEF46DB3751D8E999, "xxhash64: empty input");
+        check(koncar::xxhash64(bytes_of("abc")) == 0x44BC2CF5AD770999, "xxhash64: \"abc\"");
+
+        // Pieces of every size up to two stripes go through the internal buffer
+        std::mt19937 random(9);
+        const std::vector<std::uint8_t> data = random_bytes(random, 5000);
+        bool same = true;
+        for (std::size_t piece = 1; piece <= 64; ++piece) {
+            koncar::detail::xxhash64_state state;
+            for (std::size_t first = 0; first < data.size(); first += piece)
+                state.update(data.data() + first, std::min(piece, data.size() - first));
+            same = same && state.finish() == koncar::xxhash64(data);
+        }
+        check(same, "xxhash64: incremental updates match the one-shot hash");
+        check(koncar::xxhash64(data, 1) != koncar::xxhash64(data), "xxhash64: the seed changes the hash");
+    }
+
+    void checksummed_strings() {
+        const std::vector<std::uint8_t> digits{ '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+        const std::string crc_text = koncar::binary_to_string(digits, koncar::checksum::crc32c);
+        check(crc_text == koncar::binary_to_string(digits) + "E3069283", "strings: the CRC follows the data, most significant digit first");
+        const std::string xxh_text = koncar::binary_to_string({ 'a', 'b', 'c' }, koncar::checksum::xxhash64, false);
+        check(xxh_text == "61626344bc2cf5ad770999", "strings: the XXH64 follows the data");
+
+        std::mt19937 random(4);
+        bool round_trip = true;
+        for (const std::size_t size : { 0, 1, 511, 512, 513, 4096, 100001 }) {
+            const std::vector<std::uint8_t> data = random_bytes(random, size);
+            for (const koncar::checksum kind : { koncar::checksum::crc32c, koncar::checksum::xxhash64 })
+                round_trip = round_trip && koncar::string_to_binary(koncar::binary_to_string(data, kind), kind) == data;
+        }
+        check(round_trip, "strings: data survives a round trip with either checksum");
+
+        std::string corrupted = crc_text;
+        corrupted[3] = corrupted[3] == '0' ? '1' : '0';
+        check(koncar::string_to_binary(corrupted, koncar::checksum::crc32c).empty(), "strings: a changed digit fails verification");
+        check(koncar::string_to_binary("E30692", koncar::checksum::crc32c).empty(), "strings: text shorter than the checksum fails");
+    }
+
+}
+
+int main() {
+    crc32c_vectors();
+    crc32c_random();
+    xxhash64_vectors();
+    checksummed_strings();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Licence information: Copyright Filip Matjašec©
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Tests of the SHA-256 chunk names and of koncar::chunk_store lookups and deduplication.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++20 -O2 -pthread tests/chunk_store_test.cpp -o chunk_store_test
+//   ./chunk_store_test
+//
+// Every check prints its name; the exit status is 0 when all of them pass.
+
+#include "../Koncar_assignment.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace {
+
+    int failures = 0;
+
+    void check(const bool condition, const char* what) {
+        std::printf("%s %s\n", condition ? "ok  " : "FAIL", what);
+        if (!condition)
+            ++failures;
+    }
+
+    template <typename Function>
+    bool throws_invalid_argument(Function&& function) {
+        try {
+            function();
+        } catch (const std::invalid_argument&) {
+            return true;
+        } catch (...) {
+        }
+        return false;
+    }
+
+    // Hashes `text` in pieces of `piece` bytes and returns the lower-case hexadecimal digest
+    std::string sha256_hex(const std::string_view text, const std::size_t piece = std::string_view::npos) {
+        koncar::detail::sha256 hash;
+        for (std::size_t offset = 0; offset < text.size(); offset += piece)
+            hash.update(reinterpret_cast<const std::uint8_t*>(text.data()) + offset, std::min(piece, text.size() - offset));
+        const std::array<std::uint8_t, 32> sum = hash.finish();
+        std::string hex(64, '\0');
+        koncar::detail::encode_hex(sum.data(), sum.size(), hex.data(), false);
+        return hex;
+    }
+
+    void sha256_vectors() {
+        // FIPS 180-4 examples
+        check(sha256_hex("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", "sha256: empty message");
+        check(sha256_hex("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", "sha256: \"abc\"");
+        const std::string two_blocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+        check(sha256_hex(two_blocks) == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", "sha256: 448-bit message");
+        const std::string long_message = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+        check(sha256_hex(long_message) == "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1", "sha256: 896-bit message");
+        const std::string million(1000000, 'a');
+        check(sha256_hex(million) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0", "sha256: one million 'a'");
+        check(sha256_hex(million, 7) == sha256_hex(million) && sha256_hex(long_message, 63) == sha256_hex(long_message),
+            "sha256: incremental updates across block boundaries");
+    }
+
+    void malformed_digests() {
+        koncar::chunk_store store;
+        const std::string valid(64, 'a');
+        const char* const names[] = { "", "a", "zz", "0123456789abcdef", "g" };
+        bool rejected = !store.contains(valid);
+        for (const char* name : names)
+            rejected = rejected && !store.contains(name);
+        rejected = rejected && !store.contains(std::string(63, 'a') + 'x') && !store.contains(std::string(65, 'a'));
+        check(rejected, "malformed digests: contains is false for empty, short, long and non-hex digests");
+
+        bool thrown = true;
+        for (const char* name : names)
+            thrown = thrown && throws_invalid_argument([&] { (void)store.chunk_path(name); });
+        thrown = thrown && throws_invalid_argument([&] { (void)store.chunk_path(std::string(63, 'a') + 'x'); });
+        check(thrown, "malformed digests: chunk_path throws std::invalid_argument");
+        check(store.chunk_path(valid) == koncar::fs::path("aa") / valid, "malformed digests: a valid digest names its shard directory");
+    }
+
+    void deduplication() {
+        const koncar::fs::path root = koncar::fs::temp_directory_path() / "koncar_chunk_store_test";
+        koncar::fs::remove_all(root);
+        koncar::fs::create_directories(root / "tree");
+
+        std::mt19937 random(7);
+        std::string content(200000, '\0');
+        for (char& c : content)
+            c = static_cast<char>(random());
+        std::ofstream(root / "tree" / "a.bin", std::ios::binary) << content;
+        std::ofstream(root / "tree" / "b.bin", std::ios::binary) << content;
+        std::ofstream(root / "small.txt", std::ios::binary) << "abc";
+
+        {
+            koncar::chunk_store store(root / "store");
+            const koncar::chunk_store_stats stats = store.add_tree(root / "tree", koncar::execution::par);
+            check(stats.files == 2 && stats.bytes == 2 * content.size(), "deduplication: every file is read");
+            check(stats.unique_chunks * 2 == stats.chunks && stats.unique_bytes == content.size(), "deduplication: the copy adds no unique chunks");
+
+            const std::vector<koncar::chunk_store::digest> small = store.add_file(root / "small.txt");
+            check(small.size() == 1 && small[0] == sha256_hex("abc"), "deduplication: a small file is one chunk named by its SHA-256");
+            check(store.contains(small[0]) && koncar::fs::exists(store.chunk_path(small[0])), "deduplication: the chunk is indexed and written");
+        }
+
+        koncar::chunk_store reopened(root / "store");
+        check(reopened.contains(sha256_hex("abc")), "deduplication: a reopened store indexes the existing chunks");
+        check(reopened.add_tree(root / "tree").unique_chunks == 0, "deduplication: nothing is new after reopening");
+        koncar::fs::remove_all(root);
+    }
+
+}
+
+int main() {
+    sha256_vectors();
+    malformed_digests();
+    deduplication();
+    return failures ? 1 : 0;
+}
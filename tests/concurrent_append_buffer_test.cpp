@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Licence information: Copyright Filip Matjašec©
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Tests of koncar::concurrent_append_buffer when producers fail half-way through a batch.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++20 -O2 -pthread tests/concurrent_append_buffer_test.cpp -o concurrent_append_buffer_test
+//   ./concurrent_append_buffer_test
+//
+// Every check prints its name; the exit status is 0 when all of them pass.
+
+#include "../Koncar_assignment.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <ranges>
+#include <thread>
+
+namespace {
+
+    // Set to make the next global operator new throw std::bad_alloc
+    bool fail_allocation = false;
+
+    int failures = 0;
+
+    void check(const bool condition, const char* what) {
+        std::printf("%s %s\n", condition ? "ok  " : "FAIL", what);
+        if (!condition)
+            ++failures;
+    }
+
+    // Element whose construction from a negative value throws
+    struct picky {
+        int value;
+
+        picky(const int v) : value(v) {
+            if (v < 0)
+                throw std::runtime_error("negative value");
+        }
+    };
+
+    std::vector<int> consume_all(koncar::concurrent_append_buffer<picky>& buffer) {
+        std::vector<int> values;
+        buffer.consume([&](picky&& element) { values.push_back(element.value); });
+        return values;
+    }
+
+    template <typename Function>
+    bool throws(Function&& function) {
+        try {
+            function();
+        } catch (...) {
+            return true;
+        }
+        return false;
+    }
+
+    void throwing_argument_batch() {
+        koncar::concurrent_append_buffer<picky> buffer;
+        check(throws([&] { koncar::add_range(buffer, 1, -2, 3); }), "argument batch: the throwing constructor propagates");
+        koncar::add_range(buffer, 4);
+        check(consume_all(buffer) == std::vector<int>{ 1, 4 }, "argument batch: later elements are consumed");
+        check(buffer.empty(), "argument batch: the abandoned slots are not counted");
+    }
+
+    void throwing_range_batch() {
+        koncar::concurrent_append_buffer<picky> buffer;
+        const std::vector<int> values{ 1, 2, -3, 4, 5 };
+        check(throws([&] { koncar::add_range(buffer, values); }), "range batch: the throwing constructor propagates");
+        koncar::add_range(buffer, std::vector<int>{ 6, 7 });
+        check(consume_all(buffer) == std::vector<int>{ 1, 2, 6, 7 }, "range batch: later elements are consumed");
+        check(buffer.empty(), "range batch: the abandoned slots are not counted");
+    }
+
+    void throwing_range_iterator() {
+        koncar::concurrent_append_buffer<picky> buffer;
+        // The exception comes from the range itself, before the slot's constructor runs
+        const auto failing = std::views::iota(0, 4) | std::views::transform([](const int i) {
+            if (i == 2)
+                throw std::runtime_error("range failure");
+            return i;
+        });
+        check(throws([&] { koncar::add_range(buffer, failing); }), "range iterator: the exception propagates");
+        koncar::add_range(buffer, 8);
+        check(consume_all(buffer) == std::vector<int>{ 0, 1, 8 }, "range iterator: later elements are consumed");
+    }
+
+    void failing_segment_allocation() {
+        koncar::concurrent_append_buffer<picky> buffer;
+        std::vector<int> expected;
+        for (int i = 0; i < static_cast<int>(buffer.first_segment_size); ++i) {
+            koncar::add_range(buffer, i);
+            expected.push_back(i);
+        }
+        // The next slot needs the second segment
+        fail_allocation = true;
+        const bool failed = throws([&] { koncar::add_range(buffer, 100, 101); });
+        fail_allocation = false;
+        check(failed, "segment allocation: bad_alloc propagates");
+        check(buffer.size() == expected.size(), "segment allocation: no slot is claimed");
+        koncar::add_range(buffer, 102);
+        expected.push_back(102);
+        check(consume_all(buffer) == expected, "segment allocation: later elements are consumed");
+    }
+
+    void concurrent_producers() {
+        koncar::concurrent_append_buffer<picky> buffer;
+        constexpr int producers = 4;
+        constexpr int batches = 2000;
+        std::vector<std::thread> threads;
+        for (int producer = 0; producer < producers; ++producer) {
+            threads.emplace_back([&buffer, producer] {
+                for (int batch = 0; batch < batches; ++batch) {
+                    // Every third batch fails on its second element
+                    const int second = batch % 3 == 0 ? -1 : producer;
+                    try {
+                        koncar::add_range(buffer, producer, second, producer);
+                    } catch (const std::runtime_error&) {
+                    }
+                }
+            });
+        }
+        std::size_t consumed = 0;
+        for (auto& thread : threads)
+            thread.join();
+        consumed += consume_all(buffer).size();
+        const std::size_t failed_batches = (batches + 2) / 3;
+        check(consumed == producers * (3 * batches - 2 * failed_batches), "concurrent producers: every published element is consumed");
+        check(buffer.empty(), "concurrent producers: nothing is left behind");
+    }
+
+}
+
+// Lets a test make an allocation fail
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void* operator new(const std::size_t size) {
+    if (fail_allocation)
+        throw std::bad_alloc();
+    if (void* pointer = std::malloc(size ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size) { return operator new(size); }
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+#pragma GCC diagnostic pop
+
+int main() {
+    throwing_argument_batch();
+    throwing_range_batch();
+    throwing_range_iterator();
+    failing_segment_allocation();
+    concurrent_producers();
+    return failures ? 1 : 0;
+}
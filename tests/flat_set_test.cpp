@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Licence information: Copyright Filip Matjašec©
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Tests of koncar::flat_set and koncar::flat_map bulk insertion against std::set and std::map.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++20 -O2 tests/flat_set_test.cpp -o flat_set_test
+//   ./flat_set_test
+//
+// Every check prints its name; the exit status is 0 when all of them pass.
+
+#include "../Koncar_assignment.h"
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+
+namespace {
+
+    int failures = 0;
+
+    void check(const bool condition, const char* what) {
+        std::printf("%s %s\n", condition ? "ok  " : "FAIL", what);
+        if (!condition)
+            ++failures;
+    }
+
+    template <typename Flat, typename Reference>
+    bool same_elements(const Flat& flat, const Reference& reference) {
+        return std::equal(flat.begin(), flat.end(), reference.begin(), reference.end());
+    }
+
+    void merge_with_duplicates() {
+        koncar::flat_set<int> set{ 1, 5, 9 };
+        koncar::add_range(set, std::vector<int>{ 7, 3, 5, 3, 9, 0 });
+        check(same_elements(set, std::vector<int>{ 0, 1, 3, 5, 7, 9 }), "merge: duplicates in the batch and in the set are dropped");
+
+        koncar::add_range(set, 12, 10, 12, 11);
+        check(same_elements(set, std::vector<int>{ 0, 1, 3, 5, 7, 9, 10, 11, 12 }), "merge: a batch after every key is appended");
+
+        koncar::add_range(set, 9, 5, 1);
+        check(set.size() == 9, "merge: a batch of existing keys adds nothing");
+    }
+
+    void random_batches() {
+        std::mt19937 random(11);
+        koncar::flat_set<int> set;
+        std::set<int> reference;
+        bool same = true;
+        for (int round = 0; round < 200; ++round) {
+            std::vector<int> batch(random() % 64);
+            for (int& value : batch)
+                value = static_cast<int>(random() % 1000);
+            koncar::add_range(set, batch);
+            reference.insert(batch.begin(), batch.end());
+            same = same && same_elements(set, reference);
+        }
+        check(same, "random batches: the set matches std::set after every batch");
+    }
+
+    void first_value_wins() {
+        koncar::flat_map<int, std::string> map;
+        map[2] = "existing";
+        koncar::add_range(map, std::vector<std::pair<int, std::string>>{ { 3, "first" }, { 2, "batch" }, { 3, "second" }, { 1, "one" } });
+        const std::vector<std::pair<int, std::string>> expected{ { 1, "one" }, { 2, "existing" }, { 3, "first" } };
+        check(same_elements(map, expected), "map: the existing value wins, then the first one in the batch");
+
+        std::mt19937 random(5);
+        koncar::flat_map<int, int> numbers;
+        std::map<int, int> reference;
+        for (int round = 0; round < 100; ++round) {
+            std::vector<std::pair<int, int>> batch;
+            for (int i = static_cast<int>(random() % 32); i > 0; --i)
+                batch.emplace_back(static_cast<int>(random() % 200), round * 100 + i);
+            koncar::add_range(numbers, batch);
+            reference.insert(batch.begin(), batch.end());
+        }
+        check(same_elements(numbers, std::vector<std::pair<int, int>>(reference.begin(), reference.end())), "map: random batches keep the values std::map::insert keeps");
+    }
+
+    void move_only_values() {
+        koncar::flat_map<int, std::unique_ptr<int>> map;
+        std::vector<std::pair<int, std::unique_ptr<int>>> batch;
+        for (const int key : { 4, 2, 4, 1 })
+            batch.emplace_back(key, std::make_unique<int>(key * 10));
+        koncar::add_range(map, std::move(batch));
+        check(map.size() == 3 && *map.at(1) == 10 && *map.at(4) == 40, "move-only values: an owning batch is moved in");
+    }
+
+    // Ordering which throws on a chosen comparison
+    struct fragile_less {
+        std::shared_ptr<int> remaining;
+
+        bool operator()(const int lhs, const int rhs) const {
+            if (remaining && --*remaining == 0)
+                throw std::runtime_error("comparison failed");
+            return lhs < rhs;
+        }
+    };
+
+    void throwing_comparison() {
+        const auto budget = std::make_shared<int>(0);
+        koncar::flat_set<int, fragile_less> set({ 1, 2, 3 }, fragile_less{ budget });
+        *budget = 20;
+        bool thrown = false;
+        try {
+            koncar::add_range(set, std::vector<int>{ 9, 8, 7, 6, 5, 4, 0 });
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        check(thrown && set.empty(), "throwing comparison: the set is cleared");
+    }
+
+}
+
+int main() {
+    merge_with_duplicates();
+    random_batches();
+    first_value_wins();
+    move_only_values();
+    throwing_comparison();
+    return failures ? 1 : 0;
+}
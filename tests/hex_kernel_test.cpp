@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Licence information: Copyright Filip Matjašec©
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Tests of every koncar::hex_kernels() entry against the scalar kernel.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++20 -O2 tests/hex_kernel_test.cpp -o hex_kernel_test
+//   ./hex_kernel_test
+//
+// Every check prints its name; the exit status is 0 when all of them pass.
+
+#include "../Koncar_assignment.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+
+namespace {
+
+    int failures = 0;
+
+    void check(const bool condition, const std::string& what) {
+        std::printf("%s %s\n", condition ? "ok  " : "FAIL", what.c_str());
+        if (!condition)
+            ++failures;
+    }
+
+    // Every size up to a few 64-byte blocks, then random larger ones
+    std::vector<std::size_t> test_sizes(std::mt19937& random) {
+        std::vector<std::size_t> sizes;
+        for (std::size_t size = 0; size <= 300; ++size)
+            sizes.push_back(size);
+        for (int i = 0; i < 50; ++i)
+            sizes.push_back(random() % 20000);
+        return sizes;
+    }
+
+    void encoding(const koncar::hex_kernel& kernel) {
+        std::mt19937 random(1);
+        std::vector<std::uint8_t> data(20000 + 64);
+        for (std::uint8_t& byte : data)
+            byte = static_cast<std::uint8_t>(random());
+        std::string expected(2 * data.size(), '\0'), actual(2 * data.size() + 1, '\0');
+        bool same = true;
+        for (const std::size_t size : test_sizes(random)) {
+            const std::uint8_t* first = data.data() + random() % 64;
+            for (const bool uppercase : { false, true }) {
+                koncar::detail::encode_hex_scalar(first, size, expected.data(), uppercase);
+                actual[2 * size] = '#';
+                const char* end = kernel.encode(first, size, actual.data(), uppercase);
+                same = same && end == actual.data() + 2 * size && actual[2 * size] == '#'
+                    && actual.compare(0, 2 * size, expected, 0, 2 * size) == 0;
+            }
+        }
+        check(same, std::string(kernel.name) + ": encoding matches scalar for all sizes, offsets and both cases");
+    }
+
+    void decoding(const koncar::hex_kernel& kernel) {
+        std::mt19937 random(2);
+        const std::string_view digits = "0123456789abcdefABCDEF";
+        std::string text(40000 + 64, '\0');
+        for (char& c : text)
+            c = digits[random() % digits.size()];
+        std::vector<std::uint8_t> expected(text.size() / 2), actual(text.size() / 2 + 1);
+        bool same = true;
+        for (const std::size_t bytes : test_sizes(random)) {
+            const char* first = text.data() + random() % 64;
+            actual[bytes] = 0xA5;
+            same = same && koncar::detail::decode_hex_scalar(first, 2 * bytes, expected.data()) == nullptr
+                && kernel.decode(first, 2 * bytes, actual.data()) == nullptr && actual[bytes] == 0xA5
+                && std::equal(expected.begin(), expected.begin() + static_cast<std::ptrdiff_t>(bytes), actual.begin());
+        }
+        check(same, std::string(kernel.name) + ": decoding of mixed-case digits matches scalar");
+    }
+
+    void invalid_characters(const koncar::hex_kernel& kernel) {
+        // Neighbours of the digit ranges, the bytes whose values alias digits modulo 16 or 128, and NUL
+        const std::string_view invalid("/:@G`g \x80\xB0\xC1\xE6\xFF", 13);
+        const std::string invalid_with_nul = std::string(invalid) + '\0';
+        std::mt19937 random(3);
+        std::string text(4096 + 64, '\0');
+        for (char& c : text)
+            c = "0123456789abcdefABCDEF"[random() % 22];
+        std::vector<std::uint8_t> out(text.size());
+        bool located = true, single = true;
+        for (int round = 0; round < 3000; ++round) {
+            const std::size_t offset = random() % 64;
+            const std::size_t size = 2 * (1 + random() % (text.size() / 2 - 32));
+            const std::size_t position = round < 300 ? std::min<std::size_t>(static_cast<std::size_t>(round), size - 1) : random() % size;
+            std::string bad = text;
+            char* first = bad.data() + offset;
+            first[position] = invalid_with_nul[random() % invalid_with_nul.size()];
+            if (round % 3 == 0 && position + 5 < size)
+                first[position + 5] = 'x';
+            located = located && kernel.decode(first, size, out.data()) == first + position;
+            single = single && koncar::detail::decode_hex_scalar(first, size, out.data()) == first + position;
+        }
+        check(single, std::string(kernel.name) + ": the scalar reference finds the first invalid character");
+        check(located, std::string(kernel.name) + ": the position of the first invalid character matches scalar");
+    }
+
+    void selection() {
+        const std::span<const koncar::hex_kernel> kernels = koncar::hex_kernels();
+        check(!kernels.empty() && kernels.back().name == "scalar", "selection: the scalar kernel is listed last");
+        const std::vector<std::uint8_t> data(100, 0xAB);
+        std::string expected;
+        for (std::size_t i = 0; i < data.size(); ++i)
+            expected += "ab";
+        bool selected = true;
+        for (const koncar::hex_kernel& kernel : kernels) {
+            selected = selected && koncar::select_hex_kernel(kernel.name) && &koncar::active_hex_kernel() == &kernel
+                && koncar::binary_to_string(data, false) == expected;
+        }
+        check(selected, "selection: every listed kernel can be selected");
+        check(!koncar::select_hex_kernel("no such kernel") && &koncar::active_hex_kernel() == &kernels.back(),
+            "selection: an unknown name leaves the active kernel unchanged");
+        koncar::select_hex_kernel(kernels.front().name);
+    }
+
+}
+
+int main() {
+    for (const koncar::hex_kernel& kernel : koncar::hex_kernels()) {
+        encoding(kernel);
+        decoding(kernel);
+        invalid_characters(kernel);
+    }
+    selection();
+    return failures ? 1 : 0;
+}
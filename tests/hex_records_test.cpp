@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Licence information: Copyright Filip Matjašec©
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Tests of koncar::decode_hex_records line handling, bad-line reports and parallel slicing.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++20 -O2 -pthread tests/hex_records_test.cpp -o hex_records_test
+//   ./hex_records_test
+//
+// Every check prints its name; the exit status is 0 when all of them pass.
+
+#include "../Koncar_assignment.h"
+
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <string>
+
+namespace {
+
+    int failures = 0;
+
+    void check(const bool condition, const char* what) {
+        std::printf("%s %s\n", condition ? "ok  " : "FAIL", what);
+        if (!condition)
+            ++failures;
+    }
+
+    using record = std::vector<std::uint8_t>;
+
+    std::vector<record> records_of(const koncar::hex_records& records) {
+        std::vector<record> result;
+        for (std::size_t i = 0; i < records.size(); ++i)
+            result.emplace_back(records[i].begin(), records[i].end());
+        return result;
+    }
+
+    std::vector<std::uint64_t> bad_lines_of(const koncar::hex_records& records) {
+        return { records.bad_lines().begin(), records.bad_lines().end() };
+    }
+
+    // Collects the messages koncar reports while it is alive, and drops them afterwards
+    class captured_diagnostics {
+    public:
+        captured_diagnostics() {
+            koncar::default_diagnostics().set_sink(std::make_shared<koncar::function_sink>([this](const koncar::diagnostic& report) {
+                std::lock_guard lock(mutex_);
+                messages_.emplace_back(report.message());
+            }));
+        }
+
+        ~captured_diagnostics() {
+            koncar::default_diagnostics().set_sink(std::make_shared<koncar::null_sink>());
+        }
+
+        std::vector<std::string> messages() {
+            koncar::default_diagnostics().flush();
+            std::lock_guard lock(mutex_);
+            return std::exchange(messages_, {});
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector<std::string> messages_;
+    };
+
+    void line_ends() {
+        const koncar::hex_records records = koncar::decode_hex_records("BAAD\r\nf00d\r\n");
+        check(records_of(records) == std::vector<record>{ { 0xBA, 0xAD }, { 0xF0, 0x0D } } && records.bad_lines().empty(),
+            "line ends: CRLF line ends are ignored");
+        check(records_of(koncar::decode_hex_records("01\n02")) == std::vector<record>{ { 0x01 }, { 0x02 } },
+            "line ends: the last line needs no newline");
+        check(koncar::decode_hex_records("").empty() && koncar::decode_hex_records("").bytes().empty(), "line ends: empty text has no records");
+    }
+
+    void blank_lines() {
+        const koncar::hex_records records = koncar::decode_hex_records("AB\n\n \t\r\n  CD  \n");
+        check(records_of(records) == std::vector<record>{ { 0xAB }, {}, {}, { 0xCD } }, "blank lines: blank lines give empty records");
+        check(records.bad_lines().empty(), "blank lines: blank lines are not bad lines");
+        check(records.bytes().size() == 2 && records.offsets().size() == 5, "blank lines: the arena holds only the decoded bytes");
+    }
+
+    void bad_lines(captured_diagnostics& diagnostics) {
+        const koncar::hex_records records = koncar::decode_hex_records("0102\nABC\n  12zz\r\nx1\n0304\n");
+        check(records_of(records) == std::vector<record>{ { 0x01, 0x02 }, {}, {}, {}, { 0x03, 0x04 } },
+            "bad lines: bad lines give empty records and decoding continues");
+        check(bad_lines_of(records) == std::vector<std::uint64_t>{ 2, 3, 4 }, "bad lines: their line numbers are listed");
+        check(records.bytes().size() == 4, "bad lines: no bytes of a bad line remain in the arena");
+        check(diagnostics.messages() == std::vector<std::string>{
+                  "line 2: odd number of hexadecimal digits",
+                  "line 3: invalid hexadecimal character at column 5",
+                  "line 4: invalid hexadecimal character at column 1" },
+            "bad lines: each is reported with its line and column");
+
+        // A bad line after 32 valid digits goes through the vector kernel before the character is found
+        const std::string wide = std::string(64, 'a') + "\n" + std::string(40, 'b') + "g" + std::string(23, 'b') + "\n";
+        check(bad_lines_of(koncar::decode_hex_records(wide)) == std::vector<std::uint64_t>{ 2 }, "bad lines: found inside a vector block");
+        check(diagnostics.messages() == std::vector<std::string>{ "line 2: invalid hexadecimal character at column 41" },
+            "bad lines: the column inside a vector block");
+    }
+
+    void parallel_slices() {
+        std::mt19937 random(8);
+        std::string text;
+        std::vector<record> expected;
+        std::vector<std::uint64_t> expected_bad;
+        for (std::uint64_t line = 1; line <= 3000; ++line) {
+            record bytes(random() % 80);
+            for (std::uint8_t& byte : bytes)
+                byte = static_cast<std::uint8_t>(random());
+            std::string hex = koncar::binary_to_string(bytes, random() % 2 == 0);
+            if (random() % 50 == 0 && !hex.empty()) {
+                hex[random() % hex.size()] = 'q';
+                bytes.clear();
+                expected_bad.push_back(line);
+            }
+            text += hex;
+            text += random() % 4 == 0 ? "\r\n" : "\n";
+            expected.push_back(std::move(bytes));
+        }
+
+        bool same = true;
+        for (const unsigned threads : { 1u, 2u, 3u, 8u, 64u }) {
+            koncar::execution::parallel_policy policy;
+            policy.threshold = 0;
+            policy.grain = 1;
+            policy.max_threads = threads;
+            const koncar::hex_records records = koncar::decode_hex_records(text, policy);
+            same = same && records_of(records) == expected && bad_lines_of(records) == expected_bad;
+        }
+        check(same, "parallel: every slice count gives the sequential records and bad lines");
+    }
+
+}
+
+int main() {
+    {
+        captured_diagnostics diagnostics;
+        line_ends();
+        blank_lines();
+        bad_lines(diagnostics);
+    }
+    parallel_slices();
+    return failures ? 1 : 0;
+}
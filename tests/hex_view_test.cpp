@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Licence information: Copyright Filip Matjašec©
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Tests of koncar::hex_view written to streams and appended to strings.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++20 -O2 tests/hex_view_test.cpp -o hex_view_test
+//   ./hex_view_test
+//
+// Every check prints its name; the exit status is 0 when all of them pass.
+
+#include "../Koncar_assignment.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+    int failures = 0;
+
+    void check(const bool condition, const char* what) {
+        std::printf("%s %s\n", condition ? "ok  " : "FAIL", what);
+        if (!condition)
+            ++failures;
+    }
+
+    const std::vector<std::uint8_t> data{ 0xBA, 0xAD, 0xF0, 0x0D };
+
+    template <typename Manipulate>
+    std::string streamed(Manipulate&& manipulate, const koncar::hex_view& view) {
+        std::ostringstream out;
+        manipulate(out);
+        out << view << '|' << view;
+        return out.str();
+    }
+
+    void case_of_the_view() {
+        std::ostringstream out;
+        out << koncar::hex_view(data) << ' ' << koncar::hex_view(data, false);
+        check(out.str() == "BAADF00D baadf00d", "case: upper case by default, lower case on request");
+    }
+
+    void width_fill_and_alignment() {
+        check(streamed([](std::ostream& os) { os << std::setw(12); }, koncar::hex_view(data)) == "    BAADF00D|BAADF00D",
+            "width: right-aligned by default and reset after one view");
+        check(streamed([](std::ostream& os) { os << std::setw(12) << std::setfill('*'); }, koncar::hex_view(data)) == "****BAADF00D|BAADF00D",
+            "fill: the stream's fill character pads the text");
+        check(streamed([](std::ostream& os) { os << std::left << std::setw(10) << std::setfill('-'); }, koncar::hex_view(data, false)) == "baadf00d--|baadf00d",
+            "alignment: std::left pads after the text");
+        check(streamed([](std::ostream& os) { os << std::setw(2); }, koncar::hex_view(data)) == "BAADF00D|BAADF00D",
+            "width: a width below the text length does not truncate");
+        check(streamed([](std::ostream& os) { os << std::setw(3) << std::setfill('#'); }, koncar::hex_view({})) == "###|",
+            "width: an empty view is all padding");
+
+        std::ostringstream wide;
+        wide << std::setw(5008) << std::setfill('#') << koncar::hex_view(data);
+        check(wide.str() == std::string(5000, '#') + "BAADF00D", "width: padding longer than the encoding block");
+    }
+
+    void large_views() {
+        std::vector<std::uint8_t> big(std::size_t{ 1 } << 20);
+        for (std::size_t i = 0; i < big.size(); ++i)
+            big[i] = static_cast<std::uint8_t>(i * 7);
+        std::ostringstream out;
+        out << koncar::hex_view(big, false);
+        check(out.str() == koncar::binary_to_string(big, false), "large view: the text matches binary_to_string");
+
+        std::string appended = "id=";
+        koncar::str_append(appended, koncar::hex_view(big), ';');
+        check(appended == "id=" + koncar::binary_to_string(big) + ";", "large view: str_append encodes into the string");
+    }
+
+    void failing_streams() {
+        std::ostringstream failed;
+        failed.setstate(std::ios::failbit);
+        failed << koncar::hex_view(data);
+        check(failed.str().empty(), "failing stream: nothing is written to a failed stream");
+
+        std::ofstream full("/dev/full");
+        if (full) {
+            full << koncar::hex_view(std::vector<std::uint8_t>(100000, 1));
+            full.flush();
+            check(full.bad(), "failing stream: a write error sets badbit");
+        }
+    }
+
+}
+
+int main() {
+    case_of_the_view();
+    width_fill_and_alignment();
+    large_views();
+    failing_streams();
+    return failures ? 1 : 0;
+}
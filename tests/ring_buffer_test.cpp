@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Licence information: Copyright Filip Matjašec©
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Tests of koncar::ring_buffer wraparound, batches larger than the capacity and concurrent producers.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++20 -O2 -pthread tests/ring_buffer_test.cpp -o ring_buffer_test
+//   ./ring_buffer_test
+//
+// Every check prints its name; the exit status is 0 when all of them pass.
+
+#include "../Koncar_assignment.h"
+
+#include <cstdio>
+#include <numeric>
+#include <thread>
+
+namespace {
+
+    int failures = 0;
+
+    void check(const bool condition, const char* what) {
+        std::printf("%s %s\n", condition ? "ok  " : "FAIL", what);
+        if (!condition)
+            ++failures;
+    }
+
+    template <typename Function>
+    bool throws_length_error(Function&& function) {
+        try {
+            function();
+        } catch (const std::length_error&) {
+            return true;
+        } catch (...) {
+        }
+        return false;
+    }
+
+    std::vector<int> sequence(const int first, const int count) {
+        std::vector<int> values(static_cast<std::size_t>(count));
+        std::iota(values.begin(), values.end(), first);
+        return values;
+    }
+
+    void wraparound() {
+        koncar::spsc_ring_buffer<int> ring(6);
+        check(ring.capacity() == 8, "wraparound: the capacity is rounded up to a power of two");
+
+        // Moves the head to slot 5, so the next batch of 6 wraps after 3 elements
+        std::vector<int> received;
+        koncar::add_range(ring, sequence(0, 5));
+        ring.drain(received);
+        koncar::add_range(ring, 10, 11, 12, 13, 14, 15);
+        const std::span<int> first = ring.peek_batch();
+        check(first.size() == 3 && first[0] == 10 && first[2] == 12, "wraparound: peek_batch stops at the end of the storage");
+        ring.release(first.size());
+        const std::span<int> second = ring.peek_batch();
+        check(second.size() == 3 && second[0] == 13 && second[2] == 15, "wraparound: the next peek_batch continues at the start");
+        ring.release(second.size());
+        check(ring.empty() && ring.peek_batch().empty(), "wraparound: the ring is empty afterwards");
+
+        // Many laps around the storage keep the order
+        received.clear();
+        for (int lap = 0; lap < 100; ++lap) {
+            koncar::add_range(ring, sequence(lap * 7, 7));
+            ring.drain(received);
+        }
+        check(received == sequence(0, 700), "wraparound: elements keep their order over many laps");
+    }
+
+    void batches_larger_than_capacity() {
+        koncar::spsc_ring_buffer<int> ring(4);
+        check(throws_length_error([&] { koncar::add_range(ring, 1, 2, 3, 4, 5); }), "large batch: an argument batch beyond the capacity throws");
+        check(ring.empty(), "large batch: nothing is published by the rejected batch");
+
+        koncar::add_range(ring, 1, 2, 3);
+        check(ring.try_push_range(sequence(4, 3)) == 1 && !ring.try_push(9), "large batch: try_push_range pushes only what fits");
+        std::vector<int> received;
+        ring.drain(received);
+        check(received == sequence(1, 4), "large batch: the partial range follows the earlier batch");
+
+        // A range of 10000 elements passes through the 4 slots in ring-sized batches
+        received.clear();
+        std::thread consumer([&] {
+            while (received.size() < 10000) {
+                if (ring.drain(received) == 0)
+                    std::this_thread::yield();
+            }
+        });
+        koncar::add_range(ring, sequence(0, 10000));
+        consumer.join();
+        check(received == sequence(0, 10000), "large batch: a range larger than the capacity arrives complete and in order");
+    }
+
+    // Element whose construction from a negative value throws
+    struct picky {
+        int value;
+
+        picky(const int v) : value(v) {
+            if (v < 0)
+                throw std::runtime_error("negative value");
+        }
+    };
+
+    void throwing_single_producer() {
+        koncar::spsc_ring_buffer<picky> ring(8);
+        bool thrown = false;
+        try {
+            koncar::add_range(ring, 1, 2, -3, 4);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        std::vector<int> values;
+        ring.consume([&](picky&& element) { values.push_back(element.value); });
+        check(thrown && values == std::vector<int>{ 1, 2 }, "throwing element: the elements before the exception are published");
+    }
+
+    void concurrent_producers() {
+        constexpr int producers = 4;
+        constexpr int per_producer = 20000;
+        koncar::mpsc_ring_buffer<std::pair<int, int>> ring(64);
+        std::vector<std::thread> threads;
+        for (int producer = 0; producer < producers; ++producer) {
+            threads.emplace_back([&ring, producer] {
+                for (int i = 0; i < per_producer; i += 2)
+                    koncar::add_range(ring, std::pair{ producer, i }, std::pair{ producer, i + 1 });
+            });
+        }
+        std::vector<int> next(producers, 0);
+        bool ordered = true, whole = true, complete = true;
+        int received = 0;
+        std::pair<int, int> previous{ -1, -1 };
+        while (received < producers * per_producer) {
+            std::span<std::pair<int, int>> batch = ring.peek_batch();
+            if (batch.empty()) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (const auto& element : batch) {
+                const auto [producer, value] = element;
+                ordered = ordered && value == next[static_cast<std::size_t>(producer)];
+                // The second element of a batch directly follows the first
+                whole = whole && (value % 2 == 0 || previous == std::pair{ producer, value - 1 });
+                next[static_cast<std::size_t>(producer)] = value + 1;
+                previous = element;
+            }
+            received += static_cast<int>(batch.size());
+            ring.release(batch.size());
+        }
+        for (auto& thread : threads)
+            thread.join();
+        for (const int count : next)
+            complete = complete && count == per_producer;
+        check(ordered, "concurrent producers: each producer's elements arrive in order");
+        check(whole, "concurrent producers: batches of different producers never interleave");
+        check(complete && ring.empty(), "concurrent producers: every element arrives once");
+    }
+
+}
+
+int main() {
+    wraparound();
+    batches_larger_than_capacity();
+    throwing_single_producer();
+    concurrent_producers();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,173 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Licence information: Copyright Filip Matjašec©
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Tests of koncar::small_vector and koncar::static_vector growth, relocation and size limits.
+//
+// Build and run (from the repository root):
+//   g++ -std=c++20 -O2 tests/small_vector_test.cpp -o small_vector_test
+//   ./small_vector_test
+//
+// Every check prints its name; the exit status is 0 when all of them pass.
+
+#include "../Koncar_assignment.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <string>
+
+namespace {
+
+    int failures = 0;
+
+    void check(const bool condition, const char* what) {
+        std::printf("%s %s\n", condition ? "ok  " : "FAIL", what);
+        if (!condition)
+            ++failures;
+    }
+
+    template <typename Function>
+    bool throws_length_error(Function&& function) {
+        try {
+            function();
+        } catch (const std::length_error&) {
+            return true;
+        } catch (...) {
+        }
+        return false;
+    }
+
+    // Counts move constructions, so a test can tell memcpy relocation from element-wise moves
+    struct counted {
+        static inline int moves = 0;
+        int value;
+
+        counted(const int v) : value(v) {}
+        counted(const counted&) = default;
+        counted(counted&& other) noexcept : value(other.value) { ++moves; }
+        counted& operator=(const counted&) = default;
+        counted& operator=(counted&&) = default;
+    };
+
+    // The same, opted in to relocation with memcpy
+    struct relocatable_counted : counted {
+        using counted::counted;
+    };
+
+}
+
+template <>
+struct koncar::is_trivially_relocatable<relocatable_counted> : std::true_type {};
+
+namespace {
+
+    template <typename Vector>
+    bool holds_sequence(const Vector& vector, const int count) {
+        if (vector.size() != static_cast<std::size_t>(count))
+            return false;
+        for (int i = 0; i < count; ++i)
+            if (vector[static_cast<std::size_t>(i)].value != i)
+                return false;
+        return true;
+    }
+
+    void realloc_growth() {
+        koncar::small_vector<int, 4> vector;
+        for (int i = 0; i < 10000; ++i)
+            vector.push_back(i);
+        std::vector<int> expected(10000);
+        std::iota(expected.begin(), expected.end(), 0);
+        check(!vector.is_inline() && std::equal(vector.begin(), vector.end(), expected.begin(), expected.end()),
+            "realloc growth: elements survive repeated growth");
+        vector.resize(3);
+        vector.shrink_to_fit();
+        check(vector.is_inline() && vector.capacity() == 4 && vector[2] == 2, "realloc growth: shrinking returns to inline storage");
+    }
+
+    void aliasing_growth() {
+        koncar::small_vector<int, 2> numbers{ 7, 8 };
+        numbers.push_back(numbers[0]);
+        check(numbers.size() == 3 && numbers[2] == 7, "aliasing growth: push_back of an own element while growing");
+
+        koncar::small_vector<std::string, 2> strings{ "first element long enough to allocate", "b" };
+        strings.emplace(strings.begin(), strings[0]);
+        check(strings.size() == 3 && strings[0] == strings[1], "aliasing growth: emplace of an own element while growing");
+    }
+
+    void relocation_with_memcpy() {
+        koncar::small_vector<relocatable_counted, 2> vector;
+        for (int i = 0; i < 100; ++i)
+            vector.emplace_back(i);
+        vector.insert(vector.begin() + 50, relocatable_counted(-1));
+        vector.erase(vector.begin() + 50);
+        koncar::small_vector<relocatable_counted, 2> moved(std::move(vector));
+        counted::moves = 0;
+        for (int i = 100; i < 1000; ++i)
+            moved.emplace_back(i);
+        moved.insert(moved.begin(), relocatable_counted(-1));
+        moved.erase(moved.begin());
+        check(holds_sequence(moved, 1000), "memcpy relocation: contents after growth, insert and erase");
+        check(counted::moves == 1, "memcpy relocation: only the inserted element is moved");
+    }
+
+    void relocation_by_moves() {
+        counted::moves = 0;
+        koncar::small_vector<counted, 2> vector;
+        for (int i = 0; i < 100; ++i)
+            vector.emplace_back(i);
+        check(holds_sequence(vector, 100), "move relocation: contents after growth");
+        check(counted::moves > 0, "move relocation: elements without the trait are moved one by one");
+    }
+
+    void relocation_of_owning_pointers() {
+        koncar::small_vector<std::unique_ptr<int>, 2> vector;
+        for (int i = 0; i < 100; ++i)
+            vector.push_back(std::make_unique<int>(i));
+        vector.erase(vector.begin(), vector.begin() + 10);
+        bool intact = vector.size() == 90;
+        for (std::size_t i = 0; intact && i < vector.size(); ++i)
+            intact = vector[i] && *vector[i] == static_cast<int>(i) + 10;
+        check(intact, "owning pointers: unique_ptr elements survive relocation");
+    }
+
+    void size_limits() {
+        check(throws_length_error([] {
+            koncar::small_vector<int, 4> vector;
+            vector.reserve(SIZE_MAX / 4 + 2);
+            vector.resize(100);
+        }), "size limits: reserve beyond max_size() throws instead of wrapping");
+        check(throws_length_error([] {
+            koncar::small_vector<int, 4> vector;
+            vector.resize(SIZE_MAX / 2);
+        }), "size limits: resize beyond max_size() throws");
+        check(throws_length_error([] {
+            koncar::small_vector<int, 4> vector(10, 1);
+            vector.reserve(vector.max_size() + 1);
+        }), "size limits: reserve of a heap vector beyond max_size() throws");
+        check(throws_length_error([] {
+            koncar::small_vector<int, 4> vector{ 1, 2 };
+            vector.insert(vector.begin(), SIZE_MAX, 3);
+        }), "size limits: insert whose new size wraps throws");
+        check(throws_length_error([] {
+            koncar::static_vector<int, 4> vector{ 1, 2 };
+            vector.insert(vector.begin(), SIZE_MAX, 3);
+        }), "size limits: static_vector insert whose new size wraps throws");
+        check(throws_length_error([] {
+            koncar::static_vector<int, 2> vector{ 1, 2 };
+            vector.push_back(3);
+        }), "size limits: static_vector throws when full");
+    }
+
+}
+
+int main() {
+    realloc_growth();
+    aliasing_growth();
+    relocation_with_memcpy();
+    relocation_by_moves();
+    relocation_of_owning_pointers();
+    size_limits();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,742 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+// Licence information: Copyright Filip Matjašec©
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// koncar command-line tool: hexadecimal conversion and directory sizes built on Koncar_assignment.h.
+//
+// Build (from the repository root):
+//   g++ -std=c++20 -O2 -DNDEBUG -pthread tools/koncar.cpp -o koncar
+//
+// Usage:
+//   koncar hex encode   [options] [file]   binary to hexadecimal text
+//   koncar hex decode   [options] [file]   hexadecimal text, one string per line, to binary
+//   koncar hex dump     [options] [file]   offset, hexadecimal and printable characters of every line of bytes
+//   koncar hex validate [options] [file]   check that the input is hexadecimal text and count its bytes
+//   koncar du [options] path...            total size of every directory tree
+//   koncar dedup [options] path...         content-defined chunking and deduplication of files and trees
+//   koncar tune                            calibrate this host, cache the tuning and print it
+//
+// Files are memory-mapped; without a file, or with "-", the input is read from stdin, and the hex commands read,
+// convert and write it in overlapped stages so that pipes and sockets keep streaming. The output goes to stdout,
+// errors and statistics to stderr. The hex and du commands start with the tuning cached for this CPU model by
+// `koncar tune` (koncar::auto_tune), or with the built-in defaults if there is none; they never calibrate themselves.
+// The exit status is 0 on success, 1 on failure and 2 on invalid usage.
+
+#include "../Koncar_assignment.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
+
+namespace {
+
+    constexpr const char* usage_text =
+        "usage: koncar hex encode|decode|dump|validate [options] [file]\n"
+        "       koncar du [options] path...\n"
+        "       koncar dedup [options] path...\n"
+        "       koncar tune\n"
+        "\n"
+        "common options:\n"
+        "  -j, --threads N      use at most N threads, 1 runs on the calling thread (default: all)\n"
+        "  --stats              print the kernel, sizes, time and throughput to stderr\n"
+        "  --no-tune            use the built-in defaults instead of the tuning of this host (see tune)\n"
+        "\n"
+        "hex options:\n"
+        "  -c, --cols N         bytes per output line; encode: 0 is one line (default), dump: default 16\n"
+        "  -u, --upper          upper-case hexadecimal digits\n"
+        "  --kernel NAME        use the named kernel instead of the tuned one (see --list-kernels)\n"
+        "  --list-kernels       print the kernels this CPU supports, fastest first\n"
+        "\n"
+        "du options:\n"
+        "  --backend NAME       parallel (default), iterator or recursive\n"
+        "  --format NAME        text (default), json or csv\n"
+        "  -t, --threshold N    only report trees of at least N bytes\n"
+        "  -h, --human          print sizes with K, M, G, T suffixes (text format)\n"
+        "\n"
+        "dedup options:\n"
+        "  --store DIR          keep every distinct chunk once in DIR (default: only measure)\n"
+        "  --chunk N            average chunk size in bytes, a power of two from 64 to 16777216 (default 8192)\n"
+        "  --format NAME        text (default), json or csv\n"
+        "\n"
+        "tune measures the hex kernels, the parallel encode and decode thresholds and the traversal threads, and\n"
+        "caches them in $XDG_CACHE_HOME/koncar (default ~/.cache/koncar) for this CPU model; the other commands\n"
+        "use the cached tuning, or the built-in defaults until tune has run.\n";
+
+    // Largest --chunk value; a chunk may grow to 8 times the average
+    constexpr std::size_t max_average_chunk = std::size_t{ 1 } << 24;
+
+    // Invalid command line, reported together with the usage text
+    struct usage_error : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    struct options {
+        std::string command;
+        std::string subcommand;
+        std::vector<std::string> operands;
+        unsigned threads = 0;
+        bool stats = false;
+        std::size_t cols = 0;
+        bool cols_given = false;
+        bool uppercase = false;
+        std::string backend = "parallel";
+        std::string format = "text";
+        std::uint64_t threshold = 0;
+        bool human = false;
+        std::string store;
+        std::size_t chunk = 0;
+        std::string kernel;
+        bool tune = true;
+        koncar::tuning tuned;
+
+        // `base` (by default the built-in policy) limited by -j
+        koncar::execution::parallel_policy policy(koncar::execution::parallel_policy base = {}) const {
+            base.max_threads = threads;
+            if (threads == 1)
+                base.threshold = std::numeric_limits<std::size_t>::max();
+            return base;
+        }
+    };
+
+    template <typename Integer>
+    Integer parse_number(const std::string_view option, const std::string_view text) {
+        Integer value{};
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size())
+            throw usage_error(koncar::str_concat("invalid value for ", option, ": ", text));
+        return value;
+    }
+
+    // Buffered writer to stdout which hands out space to encode or decode into
+    class output {
+    public:
+        static constexpr std::size_t capacity = std::size_t{ 16 } << 20;
+
+        output() : buffer_(std::make_unique<char[]>(capacity)) {}
+
+        // Returns room for `count` characters (at most `capacity`) at the end of the buffered output
+        char* grow(const std::size_t count) {
+            if (used_ + count > capacity)
+                flush();
+            char* room = buffer_.get() + used_;
+            used_ += count;
+            return room;
+        }
+
+        // Takes back the last `count` characters handed out by grow
+        void shrink(const std::size_t count) noexcept { used_ -= count; }
+
+        void put(const char c) { *grow(1) = c; }
+
+        void put(const std::string_view text) {
+            for (std::size_t done = 0; done < text.size();) {
+                const std::size_t count = std::min(text.size() - done, capacity);
+                std::memcpy(grow(count), text.data() + done, count);
+                done += count;
+            }
+        }
+
+        void flush() {
+            if (used_ && std::fwrite(buffer_.get(), 1, used_, stdout) != used_)
+                throw std::runtime_error("cannot write the output");
+            written_ += used_;
+            used_ = 0;
+            if (std::fflush(stdout) != 0)
+                throw std::runtime_error("cannot write the output");
+        }
+
+        std::uint64_t written() const noexcept { return written_ + used_; }
+
+        std::size_t block_size() const noexcept { return capacity; }
+
+    private:
+        std::unique_ptr<char[]> buffer_;
+        std::size_t used_ = 0;
+        std::uint64_t written_ = 0;
+    };
+
+    // Passes the whole input to `consume` in one or more chunks: a memory-mapped file in one, stdin in pieces
+    template <typename Consumer>
+    std::uint64_t read_input(const std::vector<std::string>& operands, Consumer&& consume) {
+        if (operands.size() > 1)
+            throw usage_error("hex commands take at most one file");
+        if (!operands.empty() && operands.front() != "-") {
+            const koncar::mapped_file file(operands.front());
+            consume(file.bytes());
+            return file.size();
+        }
+        std::vector<std::uint8_t> chunk(std::size_t{ 1 } << 20);
+        std::uint64_t total = 0;
+        for (std::size_t count; (count = std::fread(chunk.data(), 1, chunk.size(), stdin)) != 0;) {
+            consume(std::span<const std::uint8_t>(chunk.data(), count));
+            total += count;
+        }
+        if (std::ferror(stdin))
+            throw std::runtime_error("cannot read stdin");
+        return total;
+    }
+
+    // Encodes `data` into `out` (2 * data.size() characters), in parallel when the slice is large enough
+    void encode(const std::span<const std::uint8_t> data, char* out, const bool uppercase, const koncar::execution::parallel_policy& policy) {
+        if (data.size() < policy.threshold) {
+            koncar::detail::encode_hex(data.data(), data.size(), out, uppercase);
+            return;
+        }
+        koncar::detail::parallel_slices(data.size(), policy, [&](const std::size_t first, const std::size_t last) {
+            koncar::detail::encode_hex(data.data() + first, last - first, out + 2 * first, uppercase);
+        });
+    }
+
+    // Decodes `size` characters of `text` into `out`; returns the offset of the first invalid character or npos
+    std::size_t decode(const char* text, const std::size_t size, std::uint8_t* out, const koncar::execution::parallel_policy& policy) {
+        if (size < policy.threshold) {
+            const char* invalid = koncar::detail::decode_hex(text, size, out);
+            return invalid ? static_cast<std::size_t>(invalid - text) : std::string_view::npos;
+        }
+        std::atomic<std::size_t> first_invalid{ std::string_view::npos };
+        koncar::detail::parallel_slices(size / 2, policy, [&](const std::size_t first, const std::size_t last) {
+            if (const char* invalid = koncar::detail::decode_hex(text + 2 * first, 2 * (last - first), out + first)) {
+                std::size_t offset = static_cast<std::size_t>(invalid - text);
+                for (std::size_t seen = first_invalid.load(); offset < seen && !first_invalid.compare_exchange_weak(seen, offset);) {
+                }
+            }
+        });
+        return first_invalid.load();
+    }
+
+    // The converters below write to an output (or a koncar::descriptor_pipeline::writer) passed to every call
+    class hex_encoder {
+    public:
+        explicit hex_encoder(const options& opts) : policy_(opts.policy(opts.tuned.encode_policy())), cols_(opts.cols), uppercase_(opts.uppercase) {}
+
+        template <typename Output>
+        void feed(std::span<const std::uint8_t> data, Output& out) {
+            while (!data.empty()) {
+                std::size_t count = std::min(data.size(), out.block_size() / 2);
+                if (cols_)
+                    count = std::min(count, cols_ - column_);
+                encode(data.first(count), out.grow(2 * count), uppercase_, policy_);
+                data = data.subspan(count);
+                column_ += count;
+                if (column_ == cols_) {
+                    out.put('\n');
+                    column_ = 0;
+                }
+            }
+            any_ = true;
+        }
+
+        template <typename Output>
+        void finish(Output& out) {
+            if (any_ && (column_ || !cols_))
+                out.put('\n');
+        }
+
+    private:
+        koncar::execution::parallel_policy policy_;
+        std::size_t cols_;
+        bool uppercase_;
+        std::size_t column_ = 0;
+        bool any_ = false;
+    };
+
+    // Lines in the format of xxd: offset, groups of two bytes in hexadecimal, printable characters
+    class hex_dumper {
+    public:
+        explicit hex_dumper(const options& opts) : cols_(opts.cols_given ? opts.cols : 16), uppercase_(opts.uppercase) {
+            if (cols_ == 0 || cols_ > 256)
+                throw usage_error("dump needs 1 to 256 bytes per line");
+            pending_.reserve(cols_);
+        }
+
+        template <typename Output>
+        void feed(std::span<const std::uint8_t> data, Output& out) {
+            if (!pending_.empty()) {
+                const std::size_t count = std::min(data.size(), cols_ - pending_.size());
+                pending_.insert(pending_.end(), data.begin(), data.begin() + count);
+                data = data.subspan(count);
+                if (pending_.size() < cols_)
+                    return;
+                line(pending_, out);
+                pending_.clear();
+            }
+            for (; data.size() >= cols_; data = data.subspan(cols_))
+                line(data.first(cols_), out);
+            pending_.assign(data.begin(), data.end());
+        }
+
+        template <typename Output>
+        void finish(Output& out) {
+            if (!pending_.empty())
+                line(pending_, out);
+        }
+
+    private:
+        template <typename Output>
+        void line(const std::span<const std::uint8_t> bytes, Output& out) {
+            char digits[512];
+            koncar::detail::encode_hex(bytes.data(), bytes.size(), digits, uppercase_);
+
+            char offset[24];
+            std::snprintf(offset, sizeof offset, "%08llx: ", static_cast<unsigned long long>(offset_));
+            out.put(offset);
+            const std::size_t width = 2 * cols_ + (cols_ + 1) / 2;
+            char* text = out.grow(width + 1 + bytes.size() + 1);
+            std::memset(text, ' ', width + 1);
+            for (std::size_t i = 0, column = 0; i < bytes.size(); ++i) {
+                text[column++] = digits[2 * i];
+                text[column++] = digits[2 * i + 1];
+                column += i & 1;
+            }
+            text += width + 1;
+            for (const std::uint8_t byte : bytes)
+                *text++ = byte >= 0x20 && byte < 0x7F ? static_cast<char>(byte) : '.';
+            *text = '\n';
+            offset_ += bytes.size();
+        }
+
+        std::size_t cols_;
+        bool uppercase_;
+        std::vector<std::uint8_t> pending_;
+        std::uint64_t offset_ = 0;
+    };
+
+    // Decodes hexadecimal strings, one per line; blank lines and whitespace around the strings are ignored
+    class hex_decoder {
+    public:
+        // Without an output (a null pointer) the input is only validated
+        explicit hex_decoder(const options& opts) : policy_(opts.policy(opts.tuned.decode_policy())) {}
+
+        template <typename Output>
+        void feed(const std::span<const std::uint8_t> data, Output* out) {
+            std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+            if (!carry_.empty()) {
+                const std::size_t end = text.find('\n');
+                if (end == std::string_view::npos) {
+                    carry_.append(text);
+                    return;
+                }
+                carry_.append(text.substr(0, end));
+                line(carry_, out);
+                carry_.clear();
+                text.remove_prefix(end + 1);
+            }
+            for (std::size_t end; (end = text.find('\n')) != std::string_view::npos; text.remove_prefix(end + 1))
+                line(text.substr(0, end), out);
+            carry_.assign(text);
+        }
+
+        template <typename Output>
+        void finish(Output* out) {
+            if (!carry_.empty())
+                line(carry_, out);
+        }
+
+        std::uint64_t bytes() const noexcept { return bytes_; }
+        std::uint64_t lines() const noexcept { return line_number_; }
+
+    private:
+        static bool blank(const char c) noexcept { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+
+        template <typename Output>
+        void line(std::string_view text, Output* out) {
+            ++line_number_;
+            std::size_t column = 1;
+            for (; !text.empty() && blank(text.front()); text.remove_prefix(1))
+                ++column;
+            while (!text.empty() && blank(text.back()))
+                text.remove_suffix(1);
+            if (text.size() & 1)
+                throw std::runtime_error(koncar::str_concat("line ", line_number_, ": odd number of hexadecimal digits"));
+
+            if (!out && scratch_.empty())
+                scratch_.resize(output::capacity / 2);
+            for (std::size_t done = 0; done < text.size();) {
+                const std::size_t count = std::min(text.size() - done, out ? 2 * out->block_size() : output::capacity);
+                std::uint8_t* bytes = out ? reinterpret_cast<std::uint8_t*>(out->grow(count / 2)) : scratch_.data();
+                if (const std::size_t invalid = decode(text.data() + done, count, bytes, policy_); invalid != std::string_view::npos) {
+                    // Only the bytes before the invalid pair are kept
+                    if (out)
+                        out->shrink(count / 2 - invalid / 2);
+                    const unsigned char c = static_cast<unsigned char>(text[done + invalid]);
+                    char shown[8];
+                    std::snprintf(shown, sizeof shown, c >= 0x20 && c < 0x7F ? "'%c'" : "0x%02X", c);
+                    throw std::runtime_error(koncar::str_concat("line ", line_number_, ", column ", column + done + invalid,
+                                                                ": invalid hexadecimal character ", std::string_view(shown)));
+                }
+                done += count;
+                bytes_ += count / 2;
+            }
+        }
+
+        koncar::execution::parallel_policy policy_;
+        std::vector<std::uint8_t> scratch_;
+        std::string carry_;
+        std::uint64_t line_number_ = 0;
+        std::uint64_t bytes_ = 0;
+    };
+
+    void print_stats(const std::string_view what, const std::uint64_t in, const std::uint64_t out, const std::chrono::duration<double> elapsed) {
+        const double seconds = elapsed.count();
+        std::fprintf(stderr, "%.*s: kernel %.*s, %llu bytes in, %llu bytes out, %.6f s, %.1f MB/s\n",
+                     static_cast<int>(what.size()), what.data(), static_cast<int>(koncar::active_hex_kernel().name.size()),
+                     koncar::active_hex_kernel().name.data(), static_cast<unsigned long long>(in), static_cast<unsigned long long>(out),
+                     seconds, seconds > 0 ? static_cast<double>(in) / seconds / 1e6 : 0.0);
+    }
+
+    int run_hex(const options& opts) {
+        const std::string& command = opts.subcommand;
+        if (command != "encode" && command != "decode" && command != "dump" && command != "validate")
+            throw usage_error(koncar::str_concat("unknown hex command: ", command));
+
+        const bool validate = command == "validate";
+        hex_encoder encoder(opts);
+        // Only dump limits the line length
+        std::optional<hex_dumper> dumper;
+        if (command == "dump")
+            dumper.emplace(opts);
+        hex_decoder decoder(opts);
+        const auto convert = [&](const std::span<const std::uint8_t> data, auto& out) {
+            if (command == "encode")
+                encoder.feed(data, out);
+            else if (command == "dump")
+                dumper->feed(data, out);
+            else
+                decoder.feed(data, validate ? nullptr : &out);
+        };
+        const auto finish = [&](auto& out) {
+            if (command == "encode")
+                encoder.finish(out);
+            else if (command == "dump")
+                dumper->finish(out);
+            else
+                decoder.finish(validate ? nullptr : &out);
+            if (validate)
+                out.put(koncar::str_concat("valid: ", decoder.bytes(), " bytes on ", decoder.lines(), " lines\n"));
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+#ifdef KONCAR_POSIX_FILES
+        // Pipes and sockets cannot be mapped: reading, converting and writing overlap instead
+        if (opts.operands.empty() || (opts.operands.size() == 1 && opts.operands.front() == "-")) {
+            koncar::descriptor_pipeline pipeline(STDIN_FILENO, STDOUT_FILENO);
+            const koncar::pipeline_stats stats =
+                pipeline.run([&](const std::span<const std::uint8_t> block, koncar::descriptor_pipeline::writer& out) {
+                    if (block.empty())
+                        finish(out);
+                    else
+                        convert(block, out);
+                });
+            if (opts.stats)
+                print_stats(command, stats.bytes_read, stats.bytes_written, std::chrono::steady_clock::now() - start);
+            return 0;
+        }
+#endif
+
+        output out;
+        std::uint64_t in = 0;
+        try {
+            in = read_input(opts.operands, [&](const std::span<const std::uint8_t> data) { convert(data, out); });
+            finish(out);
+        } catch (...) {
+            // Keep what was converted before the error, then report it
+            out.flush();
+            throw;
+        }
+        out.flush();
+        if (opts.stats)
+            print_stats(command, in, out.written(), std::chrono::steady_clock::now() - start);
+        return 0;
+    }
+
+    std::string human_size(const std::uint64_t bytes) {
+        constexpr const char* suffixes = "KMGTPE";
+        if (bytes < 1024)
+            return std::to_string(bytes);
+        double value = static_cast<double>(bytes);
+        int unit = -1;
+        for (; value >= 1024 && unit < 5; ++unit)
+            value /= 1024;
+        char text[32];
+        std::snprintf(text, sizeof text, value < 10 ? "%.1f%c" : "%.0f%c", value, suffixes[unit]);
+        return text;
+    }
+
+    std::string json_string(const std::string_view text) {
+        std::string result = "\"";
+        for (const char c : text) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+                result += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof escaped, "\\u%04x", static_cast<unsigned>(c));
+                result += escaped;
+            } else {
+                result += c;
+            }
+        }
+        return result + '"';
+    }
+
+    std::string csv_field(const std::string_view text) {
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos)
+            return std::string(text);
+        std::string result = "\"";
+        for (const char c : text) {
+            if (c == '"')
+                result += '"';
+            result += c;
+        }
+        return result + '"';
+    }
+
+    int run_du(const options& opts) {
+        if (opts.operands.empty())
+            throw usage_error("du needs at least one path");
+        if (opts.backend != "parallel" && opts.backend != "iterator" && opts.backend != "recursive")
+            throw usage_error(koncar::str_concat("unknown du backend: ", opts.backend));
+        if (opts.format != "text" && opts.format != "json" && opts.format != "csv")
+            throw usage_error(koncar::str_concat("unknown du format: ", opts.format));
+
+        // The tuned traversal pool, unless it is the size of the default one
+        koncar::execution::parallel_policy policy = opts.policy();
+        std::optional<koncar::executor> pool;
+        if (opts.tuned.traversal_threads && opts.backend == "parallel" && !opts.threads && opts.tuned.traversal_threads != koncar::default_executor().concurrency()) {
+            pool.emplace(koncar::executor_options{ .threads = opts.tuned.traversal_threads });
+            policy.executor = &*pool;
+        }
+
+        output out;
+        if (opts.format == "json")
+            out.put("[");
+        else if (opts.format == "csv")
+            out.put("path,bytes\n");
+
+        bool first = true;
+        std::uint64_t total = 0;
+        const auto start = std::chrono::steady_clock::now();
+        int status = 0;
+        for (const std::string& path : opts.operands) {
+            std::error_code error;
+            if (!std::filesystem::exists(path, error)) {
+                std::fprintf(stderr, "koncar: cannot access %s: %s\n", path.c_str(),
+                             (error ? error : std::make_error_code(std::errc::no_such_file_or_directory)).message().c_str());
+                status = 1;
+                continue;
+            }
+            const auto path_start = std::chrono::steady_clock::now();
+            std::uint64_t size;
+            if (opts.backend == "parallel")
+                size = koncar::directory_size(path, policy);
+            else if (opts.backend == "iterator")
+                size = koncar::directory_size(path);
+            else
+                size = koncar::directory_size_recursive(path);
+            total += size;
+            if (opts.stats) {
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - path_start;
+                std::fprintf(stderr, "du %s: %s, %llu bytes, %.6f s\n", opts.backend.c_str(), path.c_str(),
+                             static_cast<unsigned long long>(size), elapsed.count());
+            }
+            if (size < opts.threshold)
+                continue;
+
+            if (opts.format == "json")
+                out.put(koncar::str_concat(first ? "\n  " : ",\n  ", "{\"path\": ", json_string(path), ", \"bytes\": ", size, "}"));
+            else if (opts.format == "csv")
+                out.put(koncar::str_concat(csv_field(path), ',', size, '\n'));
+            else
+                out.put(koncar::str_concat(opts.human ? human_size(size) : std::to_string(size), '\t', path, '\n'));
+            first = false;
+        }
+        if (opts.format == "json")
+            out.put(first ? "]\n" : "\n]\n");
+        out.flush();
+
+        // Errors met while walking the trees are reported asynchronously; print them before the statistics
+        koncar::default_diagnostics().flush();
+        if (opts.stats) {
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            std::fprintf(stderr, "du %s: %zu paths, %llu bytes, %.6f s\n", opts.backend.c_str(), opts.operands.size(),
+                         static_cast<unsigned long long>(total), elapsed.count());
+        }
+        return status;
+    }
+
+    int run_dedup(const options& opts) {
+        if (opts.operands.empty())
+            throw usage_error("dedup needs at least one path");
+        if (opts.format != "text" && opts.format != "json" && opts.format != "csv")
+            throw usage_error(koncar::str_concat("unknown dedup format: ", opts.format));
+
+        koncar::chunking_options chunking;
+        if (opts.chunk) {
+            chunking.average_size = opts.chunk;
+            chunking.min_size = opts.chunk / 4;
+            chunking.max_size = opts.chunk * 8;
+        }
+        koncar::chunk_store store(opts.store, chunking);
+
+        int status = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (const std::string& path : opts.operands) {
+            std::error_code error;
+            if (!std::filesystem::exists(path, error)) {
+                std::fprintf(stderr, "koncar: cannot access %s: %s\n", path.c_str(),
+                             (error ? error : std::make_error_code(std::errc::no_such_file_or_directory)).message().c_str());
+                status = 1;
+                continue;
+            }
+            store.add_tree(path, opts.policy());
+        }
+        // Print the errors reported while chunking before the summary
+        koncar::default_diagnostics().flush();
+
+        // Every path goes into the same store, so chunks shared between the paths are counted once
+        const koncar::chunk_store_stats stats = store.stats();
+        output out;
+        if (opts.format == "json")
+            out.put(koncar::str_concat("{\"files\": ", stats.files, ", \"bytes\": ", stats.bytes, ", \"chunks\": ", stats.chunks,
+                                       ", \"unique_chunks\": ", stats.unique_chunks, ", \"unique_bytes\": ", stats.unique_bytes,
+                                       ", \"dedup_ratio\": ", std::to_string(stats.dedup_ratio()), "}\n"));
+        else if (opts.format == "csv")
+            out.put(koncar::str_concat("files,bytes,chunks,unique_chunks,unique_bytes,dedup_ratio\n", stats.files, ',', stats.bytes, ',',
+                                       stats.chunks, ',', stats.unique_chunks, ',', stats.unique_bytes, ',', std::to_string(stats.dedup_ratio()), '\n'));
+        else
+            out.put(koncar::str_concat("files ", stats.files, "\nbytes ", stats.bytes, "\nchunks ", stats.chunks, "\nunique chunks ",
+                                       stats.unique_chunks, "\nunique bytes ", stats.unique_bytes, "\ndedup ratio ",
+                                       std::to_string(stats.dedup_ratio()), '\n'));
+        out.flush();
+        if (opts.stats) {
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            const double seconds = elapsed.count();
+            std::fprintf(stderr, "dedup: %llu bytes, %.6f s, %.1f MB/s\n", static_cast<unsigned long long>(stats.bytes), seconds,
+                         seconds > 0 ? static_cast<double>(stats.bytes) / seconds / 1e6 : 0.0);
+        }
+        return status;
+    }
+
+    // Calibrates again, replacing the cached tuning, and prints it
+    int run_tune(const options& opts) {
+        if (!opts.operands.empty())
+            throw usage_error("tune takes no operands");
+        const auto start = std::chrono::steady_clock::now();
+        const koncar::tuning tuned = koncar::auto_tune(true);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        output out;
+        out.put(koncar::str_concat("cpu                ", koncar::detail::cpu_model(), '\n'));
+        out.put(koncar::str_concat("kernel             ", tuned.kernel, '\n'));
+        const auto threshold = [&](const std::string_view label, const std::size_t bytes, const std::size_t grain) {
+            if (bytes == std::numeric_limits<std::size_t>::max())
+                out.put(koncar::str_concat(label, "never parallel\n"));
+            else
+                out.put(koncar::str_concat(label, bytes, " bytes, grain ", grain, " bytes\n"));
+        };
+        threshold("encode threshold   ", tuned.encode_threshold, tuned.encode_grain);
+        threshold("decode threshold   ", tuned.decode_threshold, tuned.decode_grain);
+        out.put(koncar::str_concat("traversal threads  ", tuned.traversal_threads, '\n'));
+        const std::filesystem::path file = koncar::tuning_cache_file();
+        out.put(koncar::str_concat("cache              ", file.empty() ? std::string("none (neither XDG_CACHE_HOME nor HOME is set)") : file.string(), '\n'));
+        out.flush();
+        if (opts.stats)
+            std::fprintf(stderr, "tune: %.6f s\n", elapsed.count());
+        return 0;
+    }
+
+    options parse(const int argc, char* argv[]) {
+        options opts;
+        int i = 1;
+        if (i < argc)
+            opts.command = argv[i++];
+        if (opts.command == "hex" && i < argc)
+            opts.subcommand = argv[i++];
+
+        const auto value = [&](const std::string_view option) -> std::string_view {
+            if (i + 1 >= argc)
+                throw usage_error(koncar::str_concat("missing value for ", option));
+            return argv[++i];
+        };
+        bool only_operands = false;
+        for (; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            if (only_operands || arg.size() < 2 || arg[0] != '-') {
+                opts.operands.emplace_back(arg);
+            } else if (arg == "--") {
+                only_operands = true;
+            } else if (arg == "-j" || arg == "--threads") {
+                opts.threads = parse_number<unsigned>(arg, value(arg));
+            } else if (arg == "--stats") {
+                opts.stats = true;
+            } else if (arg == "-c" || arg == "--cols") {
+                opts.cols = parse_number<std::size_t>(arg, value(arg));
+                opts.cols_given = true;
+            } else if (arg == "-u" || arg == "--upper") {
+                opts.uppercase = true;
+            } else if (arg == "--kernel") {
+                opts.kernel = value(arg);
+            } else if (arg == "--no-tune") {
+                opts.tune = false;
+            } else if (arg == "--store") {
+                opts.store = value(arg);
+            } else if (arg == "--chunk") {
+                opts.chunk = parse_number<std::size_t>(arg, value(arg));
+                if (!std::has_single_bit(opts.chunk) || opts.chunk < 64 || opts.chunk > max_average_chunk)
+                    throw usage_error(koncar::str_concat("--chunk must be a power of two from 64 to ", max_average_chunk));
+            } else if (arg == "--backend") {
+                opts.backend = value(arg);
+            } else if (arg == "--format") {
+                opts.format = value(arg);
+            } else if (arg == "-t" || arg == "--threshold") {
+                opts.threshold = parse_number<std::uint64_t>(arg, value(arg));
+            } else if (arg == "-h" || arg == "--human") {
+                opts.human = true;
+            } else {
+                throw usage_error(koncar::str_concat("unknown option: ", arg));
+            }
+        }
+        return opts;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0) {
+            std::fputs(usage_text, stdout);
+            return 0;
+        }
+        if (std::strcmp(argv[i], "--list-kernels") == 0) {
+            for (const koncar::hex_kernel& kernel : koncar::hex_kernels())
+                std::printf("%.*s\n", static_cast<int>(kernel.name.size()), kernel.name.data());
+            return 0;
+        }
+    }
+
+    try {
+        options opts = parse(argc, argv);
+        if (opts.command == "tune")
+            return run_tune(opts);
+        if (opts.tune && (opts.command == "hex" || opts.command == "du"))
+            opts.tuned = koncar::auto_tune();
+        // An explicit kernel wins over the tuned one
+        if (!opts.kernel.empty() && !koncar::select_hex_kernel(opts.kernel))
+            throw usage_error(koncar::str_concat("kernel not supported by this CPU: ", opts.kernel));
+        if (opts.command == "hex")
+            return run_hex(opts);
+        if (opts.command == "du")
+            return run_du(opts);
+        if (opts.command == "dedup")
+            return run_dedup(opts);
+        throw usage_error(opts.command.empty() ? "missing command" : koncar::str_concat("unknown command: ", opts.command));
+    } catch (const usage_error& e) {
+        std::fprintf(stderr, "koncar: %s\n\n%s", e.what(), usage_text);
+        return 2;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "koncar: %s\n", e.what());
+        return 1;
+    }
+}